@@ -0,0 +1,98 @@
+#include "BoardView.h"
+
+BoardView::BoardView()
+{
+	this->square_size = 0.0f;
+
+	this->textures = nullptr;
+	this->sprites = nullptr;
+}
+
+BoardView::BoardView(sf::Vector2f pos, float square_size)
+{
+	this->pos = pos;
+	this->square_size = square_size;
+
+	this->lines = sf::VertexArray(sf::Lines, 36);
+
+	for (int i = 0; i < 17; i += 2)
+	{
+		this->lines[i] = sf::Vertex(this->pos + sf::Vector2f(i / 2 * this->square_size, 0.0f), sf::Color::Black);
+		this->lines[i + 1] = sf::Vertex(this->pos + sf::Vector2f(i / 2 * this->square_size, 8 * this->square_size), sf::Color::Black);
+	}
+
+	for (int i = 0; i < 17; i += 2)
+	{
+		this->lines[i + 18] = sf::Vertex(this->pos + sf::Vector2f(0.0f, i / 2 * this->square_size), sf::Color::Black);
+		this->lines[i + 19] = sf::Vertex(this->pos + sf::Vector2f(8 * this->square_size, i / 2 * this->square_size), sf::Color::Black);
+	}
+
+	this->quads = sf::VertexArray(sf::Quads, 128);
+
+	int n = 0;
+	for (int i = 0; i < 8; i++)
+	{
+		for (int j = 0; j < 8; j++)
+		{
+			if ((j % 2 + i % 2) % 2 != 0)
+			{
+				this->quads[n] = sf::Vertex(this->pos + sf::Vector2f(j * this->square_size, i * this->square_size), sf::Color::Black);
+				this->quads[n + 1] = sf::Vertex(this->pos + sf::Vector2f((j + 1) * this->square_size, i * this->square_size), sf::Color::Black);
+				this->quads[n + 2] = sf::Vertex(this->pos + sf::Vector2f((j + 1) * this->square_size, (i + 1) * this->square_size), sf::Color::Black);
+				this->quads[n + 3] = sf::Vertex(this->pos + sf::Vector2f(j * this->square_size, (i + 1) * this->square_size), sf::Color::Black);
+				n += 4;
+			}
+		}
+	}
+
+	this->textures = new sf::Texture[12];
+	this->sprites = new sf::Sprite[12];
+
+	this->textures[0].loadFromFile("../Textures/chess24/wK.png");
+	this->textures[1].loadFromFile("../Textures/chess24/wQ.png");
+	this->textures[2].loadFromFile("../Textures/chess24/wR.png");
+	this->textures[3].loadFromFile("../Textures/chess24/wB.png");
+	this->textures[4].loadFromFile("../Textures/chess24/wN.png");
+	this->textures[5].loadFromFile("../Textures/chess24/wP.png");
+
+	this->textures[6].loadFromFile("../Textures/chess24/bK.png");
+	this->textures[7].loadFromFile("../Textures/chess24/bQ.png");
+	this->textures[8].loadFromFile("../Textures/chess24/bR.png");
+	this->textures[9].loadFromFile("../Textures/chess24/bB.png");
+	this->textures[10].loadFromFile("../Textures/chess24/bN.png");
+	this->textures[11].loadFromFile("../Textures/chess24//bP.png");
+
+	for (int i = 0; i < 12; i++)
+	{
+		this->textures[i].setSmooth(true);
+		this->sprites[i].setTexture(this->textures[i]);
+		this->sprites[i].scale(this->square_size / this->textures[i].getSize().x, this->square_size / this->textures[i].getSize().x);
+	}
+}
+
+float BoardView::getSquareSize()
+{
+	return this->square_size;
+}
+
+sf::FloatRect BoardView::getRect()
+{
+	return sf::FloatRect(this->pos, sf::Vector2f(this->square_size, this->square_size) * 8.0f);
+}
+
+void BoardView::render(sf::RenderWindow& window, Board& board)
+{
+	window.draw(this->lines);
+	window.draw(this->quads);
+
+	bitboard_t occupancy = board.getOccupancy();
+	while (occupancy)
+	{
+		uint8_t square = pop_lsb(occupancy);
+		Figure figure;
+		board.getFigure(to_pos(square), figure);
+
+		this->sprites[figure].setPosition(this->pos + sf::Vector2f(square % 8, 7 - square / 8) * this->square_size);
+		window.draw(this->sprites[figure]);
+	}
+}
\ No newline at end of file
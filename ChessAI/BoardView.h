@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Board.h"
+#include <SFML/Graphics.hpp>
+
+class BoardView
+{
+public:
+	BoardView();
+	BoardView(sf::Vector2f pos, float square_size);
+
+	float getSquareSize();
+	sf::FloatRect getRect();
+
+	void render(sf::RenderWindow& window, Board& board);
+
+private:
+	sf::Vector2f pos;
+	float square_size;
+	sf::VertexArray lines, quads;
+
+	sf::Texture* textures;
+	sf::Sprite* sprites;
+};
@@ -1,68 +1,9 @@
 #pragma once
 
-#include "Board.h"
-#include <chrono>
-
-struct Move
-{
-	Move(Figure figure, pos_t from, pos_t to);
-
-	Figure figure;
-	pos_t from;
-	pos_t to;
-
-	bool capture = false;
-	bool en_passant = false;
-	bool promotion = false;
-	bool short_castling = false;
-	bool long_castling = false;
-
-	bool check = false;
-	bool checkmate = false;
-	bool draw = false;
-
-	friend bool operator== (Move move1, Move move2);
-};
-
-struct EvalMove
-{
-	float score;
-	Move move = Move(wK, pos_t(0, 0), pos_t(0, 0));
-};
-
-struct CastlingData
-{
-	bool white_castling_done = false;
-	bool black_castling_done = false;
-
-	bool wk_moved = false;
-	bool white_rook_moved[2] = { false, false };
-
-	bool bk_moved = false;
-	bool black_rook_moved[2] = { false, false };
-
-	void updateData(Move& move);
-};
-
-struct ChessGameData
-{
-	Board board;
-	std::vector<Move> moves;
-	Move prev_move = Move(wK, pos_t(0, 0), pos_t(0, 0));
-
-	CastlingData castling;
-
-	std::vector<pos_t> white_attacked_poses;
-	std::vector<pos_t> black_attacked_poses;
-};
-
-enum Ending : uint8_t
-{
-	WHITE_WIN,
-	BLACK_WIN,
-	STALEMATE,
-	IMPOSSIBILITY
-};
+#include "AsyncSearch.h"
+#include "BoardView.h"
+#include "ChessRules.h"
+#include <iostream>
 
 class ChessHandler
 {
@@ -76,16 +17,22 @@ public:
 
 private:
 	ChessGameData data;
+	BoardView view;
 
 	Ending ending;
 	bool active;
 
 	bool turn;
 	bool player_color;
-	bool frame_paused;
 
 	float score;
 
+	SearchLimits limits;
+	AsyncSearch search;
+
+	bool ponder;
+	move16_t ponder_move;
+
 	bool is_selected;
 	pos_t selected_pos;
 	std::vector<Move> selected_possible_moves;
@@ -93,26 +40,12 @@ private:
 	sf::Font font;
 	sf::Text moves_text;
 	sf::Text ending_text;
-
-	static void move(Board* board, Move move);
-
-	static float calcScore(ChessGameData* data, bool active, Ending ending);
-
-	static bool checkMove(ChessGameData* data, Move& move, bool conside_defend);
-	static bool checkCheck(ChessGameData* data, bool& wk_check, bool& bk_check);
-	static bool isAvailable(ChessGameData* data, Move& move);
-
-	static std::vector<Move> findPossibleMoves(ChessGameData* data, pos_t pos, bool conside_defend = false);
-	static void findAttackedPoses(ChessGameData* data);
-
-	static bool checkEnding(ChessGameData* data, Ending& ending);
+	sf::Text search_text;
 
 	void select(pos_t pos);
 	void unselect();
 
 	void update(Move move);
 
-	static EvalMove minimax(ChessGameData* data, int depth, bool turn, float alpha, float beta);
-
 	void boardClick(sf::Vector2f mpos);
 };
@@ -0,0 +1,270 @@
+#include "Uci.h"
+#include "Perft.h"
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+Uci::Uci()
+{
+	ChessRules::loadFen(&this->data, START_FEN, this->turn);
+
+	this->info = nullptr;
+	this->infinite = false;
+	this->threads = 1;
+}
+
+Uci::~Uci()
+{
+	this->stop();
+}
+
+void Uci::loop()
+{
+	std::string line;
+
+	while (std::getline(std::cin, line))
+	{
+		std::istringstream stream(line);
+
+		std::string command;
+		stream >> command;
+
+		if (command == "uci")
+		{
+			this->send("id name ChessAI");
+			this->send("id author ttser1085");
+			this->send("option name Hash type spin default 16 min 1 max 4096");
+			this->send("option name Threads type spin default 1 min 1 max 256");
+			this->send("option name Ponder type check default false");
+			this->send("option name EvalFile type string default <empty>");
+			this->send("uciok");
+		}
+		else if (command == "isready")
+			this->send("readyok");
+		else if (command == "setoption")
+		{
+			std::string token, name, value;
+
+			while (stream >> token)
+			{
+				if (token == "name")
+					stream >> name;
+				else if (token == "value")
+				{
+					// The value runs to the end of the line, file paths may hold spaces.
+					std::getline(stream >> std::ws, value);
+					break;
+				}
+			}
+
+			if (name == "Hash" && std::atoi(value.c_str()) > 0)
+			{
+				this->stop();
+				Search::tt.resize(std::atoi(value.c_str()));
+			}
+			else if (name == "Threads" && std::atoi(value.c_str()) > 0)
+				this->threads = std::atoi(value.c_str());
+			else if (name == "EvalFile" && !value.empty())
+			{
+				this->stop();
+				if (!nnue_load(value.c_str()))
+					this->send("info string cannot load " + value + (nnue_enabled() ? ", keeping the previous network" : ", using the handcrafted evaluation"));
+			}
+		}
+		else if (command == "ucinewgame")
+		{
+			this->stop();
+			Search::tt.clear();
+		}
+		else if (command == "position")
+			this->position(stream);
+		else if (command == "go")
+			this->go(stream);
+		else if (command == "ponderhit")
+		{
+			if (this->info != nullptr)
+				this->info->pondering = false;
+		}
+		else if (command == "stop")
+			this->stop();
+		else if (command == "quit")
+			break;
+	}
+
+	this->stop();
+}
+
+void Uci::send(std::string line)
+{
+	std::lock_guard<std::mutex> lock(this->output_mutex);
+	std::cout << line << std::endl;
+}
+
+void Uci::position(std::istringstream& stream)
+{
+	this->stop();
+
+	std::string token, fen;
+	stream >> token;
+
+	if (token == "startpos")
+	{
+		fen = START_FEN;
+		stream >> token;
+	}
+	else if (token == "fen")
+	{
+		while (stream >> token && token != "moves")
+			fen += token + " ";
+	}
+
+	if (!ChessRules::loadFen(&this->data, fen.c_str(), this->turn))
+	{
+		this->send("info string invalid position, using the initial one");
+		ChessRules::loadFen(&this->data, START_FEN, this->turn);
+		return;
+	}
+
+	if (token != "moves")
+		return;
+
+	while (stream >> token)
+	{
+		Move move;
+		if (!ChessRules::parseMove(&this->data, token, this->turn, move))
+		{
+			this->send("info string illegal move " + token);
+			return;
+		}
+
+		UndoData undo;
+		ChessRules::makeMove(&this->data, move, undo);
+		this->turn = !this->turn;
+	}
+}
+
+void Uci::go(std::istringstream& stream)
+{
+	this->stop();
+
+	SearchLimits limits;
+	int time[2] = { 0, 0 };
+	int inc[2] = { 0, 0 };
+
+	this->infinite = false;
+	bool ponder = false;
+
+	std::string token;
+	while (stream >> token)
+	{
+		if (token == "perft")
+		{
+			int depth = 1;
+			stream >> depth;
+
+			auto start = std::chrono::steady_clock::now();
+			uint64_t nodes = 0;
+
+			for (auto& result : perft_divide(&this->data, this->turn, depth))
+			{
+				this->send(to_uci(result.first) + ": " + std::to_string(result.second));
+				nodes += result.second;
+			}
+
+			auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+			this->send("");
+			this->send("Nodes searched: " + std::to_string(nodes));
+			this->send("info string time " + std::to_string(elapsed) + " ms nps " + std::to_string(elapsed > 0 ? nodes * 1000 / elapsed : nodes));
+			return;
+		}
+		else if (token == "depth")
+			stream >> limits.depth;
+		else if (token == "movetime")
+			stream >> limits.move_time;
+		else if (token == "wtime")
+			stream >> time[0];
+		else if (token == "btime")
+			stream >> time[1];
+		else if (token == "winc")
+			stream >> inc[0];
+		else if (token == "binc")
+			stream >> inc[1];
+		else if (token == "nodes")
+			stream >> limits.nodes;
+		else if (token == "infinite")
+			this->infinite = true;
+		else if (token == "ponder")
+			ponder = true;
+	}
+
+	limits.time_left = time[!this->turn];
+	limits.increment = inc[!this->turn];
+	limits.threads = this->threads;
+
+	this->info = new SearchInfo();
+	this->info->pondering = ponder;
+	this->search_thread = std::thread(&Uci::search, this, this->data, this->turn, limits);
+}
+
+void Uci::stop()
+{
+	if (this->info == nullptr)
+		return;
+
+	this->info->stop_requested = true;
+	this->search_thread.join();
+
+	delete this->info;
+	this->info = nullptr;
+}
+
+void Uci::search(ChessGameData data, bool turn, SearchLimits limits)
+{
+	MoveList list;
+	ChessRules::generateMoves(&data, list);
+
+	if (list.size == 0)
+	{
+		this->send("bestmove 0000");
+		return;
+	}
+
+	this->info->report = [this, &data, turn](EvalMove& best) { this->report(&data, turn, best); };
+
+	EvalMove best = Search::iterativeDeepening(&data, turn, limits, this->info);
+
+	// In infinite and ponder mode the best move may only be sent after stop,
+	// or after ponderhit for a ponder search that has already finished.
+	while ((this->infinite || this->info->pondering) && !this->info->stop_requested)
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+	std::vector<move16_t> pv = Search::extractPv(&data, turn, best.move, 2, this->info->tt);
+
+	this->send("bestmove " + to_uci(best.move) + (pv.size() == 2 ? " ponder " + to_uci(pv[1]) : ""));
+}
+
+void Uci::report(ChessGameData* data, bool turn, EvalMove& best)
+{
+	auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - this->info->start).count();
+
+	float score = turn ? best.score : -best.score;
+
+	std::string str = "info depth " + std::to_string(this->info->depth) + " seldepth " + std::to_string(this->info->stats.seldepth);
+
+	// Mate scores carry no distance, so they are sent as the centipawns of
+	// +-300 rather than as a made-up number of moves.
+	str += " score cp " + std::to_string((int)std::round(score / 11.2f * 100.0f));
+
+	uint64_t nodes = this->info->totalNodes();
+
+	str += " nodes " + std::to_string(nodes);
+	str += " nps " + std::to_string(elapsed > 0 ? nodes * 1000 / elapsed : nodes);
+	str += " time " + std::to_string(elapsed);
+	str += " pv";
+
+	for (move16_t move : Search::extractPv(data, turn, best.move, this->info->depth, this->info->tt))
+		str += " " + to_uci(move);
+
+	this->send(str);
+}
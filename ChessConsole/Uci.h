@@ -0,0 +1,38 @@
+#pragma once
+
+#include "ChessRules.h"
+#include "Search.h"
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+// UCI front end over stdin/stdout. The search runs on its own thread so
+// that stop, isready and quit are answered while it is thinking.
+class Uci
+{
+public:
+	Uci();
+	~Uci();
+
+	void loop();
+
+private:
+	ChessGameData data;
+	bool turn;
+
+	std::thread search_thread;
+	SearchInfo* info;
+	bool infinite;
+	int threads;
+
+	std::mutex output_mutex;
+
+	void send(std::string line);
+
+	void position(std::istringstream& stream);
+	void go(std::istringstream& stream);
+	void stop();
+
+	void search(ChessGameData data, bool turn, SearchLimits limits);
+	void report(ChessGameData* data, bool turn, EvalMove& best);
+};
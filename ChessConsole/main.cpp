@@ -0,0 +1,447 @@
+#include "ChessRules.h"
+#include "Match.h"
+#include "Perft.h"
+#include "Search.h"
+#include "Uci.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+bool is_keyword(const char* arg)
+{
+	const char* keywords[] = { "moves", "depth", "movetime", "wtime", "btime", "winc", "binc", "hash", "perft", "divide", "suite", "fen", "threads", "evalfile", "json" };
+
+	for (const char* keyword : keywords)
+	{
+		if (std::strcmp(arg, keyword) == 0)
+			return true;
+	}
+	return false;
+}
+
+int64_t elapsed_ms(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+void print_perft(uint64_t nodes, int64_t elapsed)
+{
+	std::cout << "nodes " << nodes << '\n';
+	std::cout << "time " << elapsed << " ms\n";
+	std::cout << "nps " << (elapsed > 0 ? nodes * 1000 / elapsed : nodes) << '\n';
+}
+
+void run_perft(ChessGameData* data, bool turn, int depth, bool divide)
+{
+	auto start = std::chrono::steady_clock::now();
+	uint64_t nodes = 0;
+
+	if (divide)
+	{
+		for (auto& result : perft_divide(data, turn, depth))
+		{
+			std::cout << to_uci(result.first) << ": " << result.second << '\n';
+			nodes += result.second;
+		}
+		std::cout << '\n';
+	}
+	else
+		nodes = perft(data, turn, depth);
+
+	print_perft(nodes, elapsed_ms(start));
+}
+
+// Returns false if any count differs from the reference.
+bool run_suite(int max_depth)
+{
+	auto start = std::chrono::steady_clock::now();
+	uint64_t total = 0;
+	bool passed = true;
+
+	for (int i = 0; i < perft_suite_size; i++)
+	{
+		const PerftPosition& position = perft_suite[i];
+
+		ChessGameData data;
+		bool turn;
+		ChessRules::loadFen(&data, position.fen, turn);
+
+		for (int depth = 1; depth <= 6 && depth <= max_depth && position.nodes[depth - 1] != 0; depth++)
+		{
+			uint64_t nodes = perft(&data, turn, depth);
+			bool ok = nodes == position.nodes[depth - 1];
+
+			std::cout << position.name << " depth " << depth << ": " << nodes << (ok ? " ok" : " FAILED, expected " + std::to_string(position.nodes[depth - 1])) << '\n';
+
+			total += nodes;
+			passed = passed && ok;
+		}
+
+		// The GUI and parseMove generate moves square by square instead.
+		int depth = std::min(max_depth, 3);
+		uint64_t mismatches = perft_possible_moves(&data, turn, depth);
+
+		std::cout << position.name << " possible moves depth " << depth << ": " << (mismatches == 0 ? "ok" : "FAILED in " + std::to_string(mismatches) + " positions") << '\n';
+		passed = passed && mismatches == 0;
+	}
+
+	for (int i = 0; i < invalid_fens_size; i++)
+	{
+		ChessGameData data;
+		bool turn;
+		bool ok = !ChessRules::loadFen(&data, invalid_fens[i], turn);
+
+		std::cout << "invalid " << invalid_fens[i] << (ok ? ": rejected ok" : ": FAILED, accepted") << '\n';
+		passed = passed && ok;
+	}
+
+	std::cout << '\n';
+	print_perft(total, elapsed_ms(start));
+	std::cout << (passed ? "all counts match" : "some counts differ") << '\n';
+
+	return passed;
+}
+
+void print_match(const MatchOptions& options, const MatchResult& result)
+{
+	float error;
+	float elo = elo_difference(result, error);
+
+	std::cout << std::fixed << std::setprecision(1);
+	std::cout << "games " << result.games() << " +" << result.wins << " =" << result.draws << " -" << result.losses;
+	std::cout << " elo " << elo + 0.0f << " +/- " << error;
+
+	if (options.sprt)
+	{
+		float lower, upper;
+		sprt_bounds(options.alpha, options.beta, lower, upper);
+		std::cout << std::setprecision(2) << " llr " << sprt_llr(result, options.elo0, options.elo1) << " (" << lower << ", " << upper << ")";
+	}
+
+	std::cout << std::defaultfloat << '\n';
+}
+
+// Arguments after "match": the first engine's limits, then optionally "vs"
+// and the second engine's, which start as a copy of the first.
+int run_match(int argc, char* argv[])
+{
+	MatchOptions options;
+	options.engines[0].limits.depth = 0;
+	options.concurrency = 0;
+
+	int engine = 0;
+
+	for (int i = 0; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "vs") == 0)
+		{
+			options.engines[1] = options.engines[0];
+			engine = 1;
+			continue;
+		}
+
+		if (std::strcmp(argv[i], "nosprt") == 0)
+		{
+			options.sprt = false;
+			continue;
+		}
+
+		if (i + 1 >= argc)
+		{
+			std::cerr << "missing value for " << argv[i] << '\n';
+			return 1;
+		}
+
+		const char* name = argv[i];
+		const char* value = argv[++i];
+
+		SearchLimits& limits = options.engines[engine].limits;
+
+		if (std::strcmp(name, "depth") == 0)
+			limits.depth = std::atoi(value);
+		else if (std::strcmp(name, "movetime") == 0)
+			limits.move_time = std::atoi(value);
+		else if (std::strcmp(name, "nodes") == 0)
+			limits.nodes = std::strtoull(value, nullptr, 10);
+		else if (std::strcmp(name, "threads") == 0)
+			limits.threads = std::atoi(value);
+		else if (std::strcmp(name, "hash") == 0)
+			options.engines[engine].hash = std::atoi(value);
+		else if (std::strcmp(name, "games") == 0)
+			options.games = std::atoi(value);
+		else if (std::strcmp(name, "concurrency") == 0)
+			options.concurrency = std::atoi(value);
+		else if (std::strcmp(name, "elo0") == 0)
+			options.elo0 = (float)std::atof(value);
+		else if (std::strcmp(name, "elo1") == 0)
+			options.elo1 = (float)std::atof(value);
+		else if (std::strcmp(name, "evalfile") == 0)
+		{
+			if (!nnue_load(value))
+			{
+				std::cerr << "cannot load network " << value << '\n';
+				return 1;
+			}
+		}
+		else if (std::strcmp(name, "openings") == 0)
+		{
+			std::ifstream file(value);
+			std::string line;
+
+			for (int number = 1; std::getline(file, line); number++)
+			{
+				if (line.empty())
+					continue;
+
+				ChessGameData data;
+				bool turn;
+				if (ChessRules::loadFen(&data, line.c_str(), turn))
+					options.openings.push_back(line);
+				else
+					std::cerr << "skipping invalid opening on line " << number << " of " << value << '\n';
+			}
+
+			if (options.openings.empty())
+			{
+				std::cerr << "no openings in " << value << '\n';
+				return 1;
+			}
+		}
+		else
+		{
+			std::cerr << "unknown option " << name << '\n';
+			return 1;
+		}
+	}
+
+	if (engine == 0)
+		options.engines[1] = options.engines[0];
+
+	// Without limits an engine thinks for 100 ms a move.
+	for (EngineConfig& config : options.engines)
+	{
+		if (config.limits.depth == 0 && config.limits.move_time == 0 && config.limits.nodes == 0)
+			config.limits.move_time = 100;
+		if (config.limits.depth == 0)
+			config.limits.depth = SearchLimits().depth;
+	}
+
+	// By default every core runs a game.
+	if (options.concurrency == 0)
+		options.concurrency = std::max(1, (int)std::thread::hardware_concurrency() / std::max(options.engines[0].limits.threads, options.engines[1].limits.threads));
+
+	MatchResult result = play_match(options, [&](const MatchResult& result)
+	{
+		if (result.games() % 10 == 0)
+			print_match(options, result);
+	});
+
+	if (result.games() % 10 != 0)
+		print_match(options, result);
+
+	if (options.sprt)
+	{
+		float lower, upper;
+		sprt_bounds(options.alpha, options.beta, lower, upper);
+
+		float llr = sprt_llr(result, options.elo0, options.elo1);
+		std::cout << (llr >= upper ? "H1 accepted" : llr <= lower ? "H0 accepted" : "inconclusive") << '\n';
+	}
+
+	return 0;
+}
+
+// Usage: ChessConsole [fen "FEN"] [moves e2e4 e7e5 ...] [depth N] [movetime MS]
+//                     [wtime MS] [btime MS] [winc MS] [binc MS] [hash MB]
+//                     [threads N] [evalfile FILE] [json]
+//        ChessConsole [fen "FEN"] [moves e2e4 e7e5 ...] perft|divide N
+//        ChessConsole suite [depth N]
+//        ChessConsole match [LIMITS] [vs LIMITS] [games N] [concurrency N]
+//                           [openings FILE] [elo0 E] [elo1 E] [nosprt]
+//                           [evalfile FILE]
+//          LIMITS: [depth N] [movetime MS] [nodes N] [hash MB] [threads N]
+// The position is the given one, or the initial one, with the moves applied.
+// evalfile loads a network to evaluate with instead of the handcrafted terms.
+// json prints the search statistics as a JSON line after every iteration,
+// with the counters of the main thread, and once more at the end with those
+// of all threads.
+// suite runs perft on the reference positions up to the given depth,
+// compares findPossibleMoves with generateMoves up to depth 3, and checks
+// that loadFen rejects impossible positions. match plays two engine
+// configurations against each other, see MatchOptions, and reports the Elo
+// difference of the first one. Without arguments the engine speaks UCI on
+// stdin/stdout.
+int main(int argc, char* argv[])
+{
+	if (argc == 1)
+	{
+		Uci uci;
+		uci.loop();
+		return 0;
+	}
+
+	if (std::strcmp(argv[1], "match") == 0)
+		return run_match(argc - 2, argv + 2);
+
+	ChessGameData data;
+	bool turn;
+	ChessRules::loadFen(&data, START_FEN, turn);
+
+	SearchLimits limits;
+	int time[2] = { 0, 0 };
+	int inc[2] = { 0, 0 };
+
+	int perft_depth = 0;
+	bool divide = false;
+	bool suite = false;
+	bool json = false;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "suite") == 0)
+		{
+			suite = true;
+			continue;
+		}
+
+		if (std::strcmp(argv[i], "json") == 0)
+		{
+			json = true;
+			continue;
+		}
+
+		if (std::strcmp(argv[i], "fen") == 0 && i + 1 < argc)
+		{
+			if (!ChessRules::loadFen(&data, argv[++i], turn))
+			{
+				std::cerr << "invalid fen " << argv[i] << '\n';
+				return 1;
+			}
+			continue;
+		}
+
+		if (std::strcmp(argv[i], "evalfile") == 0 && i + 1 < argc)
+		{
+			if (!nnue_load(argv[++i]))
+			{
+				std::cerr << "cannot load network " << argv[i] << '\n';
+				return 1;
+			}
+			continue;
+		}
+
+		if (std::strcmp(argv[i], "moves") == 0)
+		{
+			while (i + 1 < argc && !is_keyword(argv[i + 1]))
+			{
+				Move move;
+				if (!ChessRules::parseMove(&data, argv[++i], turn, move))
+				{
+					std::cerr << "illegal move " << argv[i] << '\n';
+					return 1;
+				}
+
+				UndoData undo;
+				ChessRules::makeMove(&data, move, undo);
+				turn = !turn;
+			}
+			continue;
+		}
+
+		if (i + 1 >= argc)
+		{
+			std::cerr << "missing value for " << argv[i] << '\n';
+			return 1;
+		}
+
+		int value = std::atoi(argv[++i]);
+
+		if (std::strcmp(argv[i - 1], "depth") == 0)
+			limits.depth = value;
+		else if (std::strcmp(argv[i - 1], "movetime") == 0)
+			limits.move_time = value;
+		else if (std::strcmp(argv[i - 1], "wtime") == 0)
+			time[0] = value;
+		else if (std::strcmp(argv[i - 1], "btime") == 0)
+			time[1] = value;
+		else if (std::strcmp(argv[i - 1], "winc") == 0)
+			inc[0] = value;
+		else if (std::strcmp(argv[i - 1], "binc") == 0)
+			inc[1] = value;
+		else if (std::strcmp(argv[i - 1], "hash") == 0)
+			Search::tt.resize(value);
+		else if (std::strcmp(argv[i - 1], "threads") == 0)
+			limits.threads = value;
+		else if (std::strcmp(argv[i - 1], "perft") == 0)
+			perft_depth = value;
+		else if (std::strcmp(argv[i - 1], "divide") == 0)
+		{
+			perft_depth = value;
+			divide = true;
+		}
+		else
+		{
+			std::cerr << "unknown option " << argv[i - 1] << '\n';
+			return 1;
+		}
+	}
+
+	if (suite)
+		return run_suite(limits.depth) ? 0 : 1;
+
+	if (perft_depth > 0)
+	{
+		run_perft(&data, turn, perft_depth, divide);
+		return 0;
+	}
+
+	limits.time_left = time[!turn];
+	limits.increment = inc[!turn];
+
+	if (limits.depth == SearchLimits().depth && limits.move_time == 0 && limits.time_left == 0)
+		limits.move_time = 1000;
+
+	MoveList list;
+	ChessRules::generateMoves(&data, list);
+
+	if (list.size == 0)
+	{
+		bool mate = ChessRules::isAttacked(&data, data.board.findKing(turn), !turn);
+		std::cout << "bestmove (none)\n" << (mate ? "checkmate" : "stalemate") << '\n';
+		return 0;
+	}
+
+	SearchInfo info;
+
+	if (json)
+	{
+		info.stats.timing = true;
+		info.report = [&info](EvalMove&)
+		{
+			std::cout << to_json(info.stats, info.depth, info.totalNodes(), elapsed_ms(info.start)) << '\n';
+		};
+	}
+
+	EvalMove best = Search::iterativeDeepening(&data, turn, limits, &info);
+
+	int64_t elapsed = elapsed_ms(info.start);
+
+	if (json)
+		std::cout << to_json(info.stats, info.depth, info.totalNodes(), elapsed) << '\n';
+
+	std::cout << "bestmove " << to_uci(best.move) << '\n';
+	std::cout << "score " << best.score << '\n';
+	std::cout << "depth " << info.depth << '\n';
+	std::cout << "seldepth " << info.stats.seldepth << '\n';
+	uint64_t nodes = info.totalNodes();
+
+	std::cout << "nodes " << nodes << '\n';
+	std::cout << "time " << elapsed << " ms\n";
+	std::cout << "nps " << (elapsed > 0 ? nodes * 1000 / elapsed : nodes) << '\n';
+
+	return 0;
+}
@@ -0,0 +1,112 @@
+#include "AsyncSearch.h"
+#include <algorithm>
+
+AsyncSearch::AsyncSearch()
+{
+	this->info = nullptr;
+	this->done = false;
+}
+
+AsyncSearch::~AsyncSearch()
+{
+	this->cancel();
+}
+
+void AsyncSearch::start(ChessGameData& data, bool turn, SearchLimits limits, bool ponder)
+{
+	this->cancel();
+
+	this->info = new SearchInfo();
+	this->info->pondering = ponder;
+	this->done = false;
+	this->progress = SearchProgress();
+	this->start_time = std::chrono::steady_clock::now();
+
+	this->thread = std::thread(&AsyncSearch::run, this, data, turn, limits);
+}
+
+void AsyncSearch::ponderhit()
+{
+	if (this->info != nullptr)
+		this->info->pondering = false;
+}
+
+void AsyncSearch::cancel()
+{
+	if (this->info == nullptr)
+		return;
+
+	this->info->stop_requested = true;
+	this->thread.join();
+
+	delete this->info;
+	this->info = nullptr;
+	this->done = false;
+}
+
+bool AsyncSearch::isRunning()
+{
+	return this->info != nullptr;
+}
+
+bool AsyncSearch::isPondering()
+{
+	return this->info != nullptr && this->info->pondering;
+}
+
+bool AsyncSearch::isDone()
+{
+	return this->done;
+}
+
+SearchProgress AsyncSearch::getProgress()
+{
+	std::lock_guard<std::mutex> lock(this->progress_mutex);
+
+	SearchProgress progress = this->progress;
+
+	// Between iterations only the main search thread's count is live.
+	if (this->info != nullptr && !this->done)
+	{
+		progress.nodes = std::max(progress.nodes, this->info->nodes.load(std::memory_order_relaxed));
+		progress.time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - this->start_time).count();
+	}
+
+	return progress;
+}
+
+EvalMove AsyncSearch::takeResult()
+{
+	this->thread.join();
+
+	delete this->info;
+	this->info = nullptr;
+	this->done = false;
+
+	return this->result;
+}
+
+void AsyncSearch::run(ChessGameData data, bool turn, SearchLimits limits)
+{
+	this->info->report = [this](EvalMove& best)
+	{
+		std::lock_guard<std::mutex> lock(this->progress_mutex);
+
+		this->progress.depth = this->info->depth;
+		this->progress.best = best;
+		this->progress.nodes = this->info->totalNodes();
+		this->progress.stats = this->info->stats;
+	};
+
+	this->result = Search::iterativeDeepening(&data, turn, limits, this->info);
+
+	{
+		std::lock_guard<std::mutex> lock(this->progress_mutex);
+
+		this->progress.nodes = this->info->totalNodes();
+		this->progress.stats = this->info->stats;
+		this->progress.time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - this->start_time).count();
+	}
+
+	this->done = true;
+}
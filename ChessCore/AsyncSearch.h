@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Search.h"
+#include <mutex>
+#include <thread>
+
+struct SearchProgress
+{
+	int depth = 0;
+	EvalMove best;
+
+	uint64_t nodes = 0;
+	int64_t time = 0;
+
+	SearchStats stats;
+};
+
+// Runs iterativeDeepening on a worker thread. The owner polls the progress
+// and takes the result once isDone() reports it; cancel() stops the search
+// and waits for the worker, which the destructor does as well. A ponder
+// search runs without time limits until ponderhit() is called.
+class AsyncSearch
+{
+public:
+	AsyncSearch();
+	~AsyncSearch();
+
+	void start(ChessGameData& data, bool turn, SearchLimits limits, bool ponder = false);
+	void ponderhit();
+	void cancel();
+
+	bool isRunning();
+	bool isPondering();
+	bool isDone();
+
+	SearchProgress getProgress();
+	EvalMove takeResult();
+
+private:
+	std::thread thread;
+	SearchInfo* info;
+	std::chrono::steady_clock::time_point start_time;
+
+	std::atomic<bool> done;
+	EvalMove result;
+
+	std::mutex progress_mutex;
+	SearchProgress progress;
+
+	void run(ChessGameData data, bool turn, SearchLimits limits);
+};
@@ -0,0 +1,170 @@
+#include "Bitboard.h"
+
+Magic rook_magics[64];
+Magic bishop_magics[64];
+
+bitboard_t knight_attacks[64];
+bitboard_t king_attacks[64];
+bitboard_t pawn_attacks[2][64];
+
+bitboard_t between_bb[64][64];
+bitboard_t line_bb[64][64];
+
+bitboard_t rook_table[0x19000];
+bitboard_t bishop_table[0x1480];
+
+bitboard_t step_bb(uint8_t square, int8_t dx, int8_t dy)
+{
+	int x = square % 8 + dx;
+	int y = square / 8 + dy;
+
+	if (x < 0 || x >= 8 || y < 0 || y >= 8)
+		return 0;
+	return square_bb(y * 8 + x);
+}
+
+bitboard_t sliding_attacks(const int8_t directions[4][2], uint8_t square, bitboard_t occupancy)
+{
+	bitboard_t attacks = 0;
+
+	for (uint8_t i = 0; i < 4; i++)
+	{
+		uint8_t s = square;
+		bitboard_t bb;
+
+		while ((bb = step_bb(s, directions[i][0], directions[i][1])) != 0)
+		{
+			attacks |= bb;
+			s = lsb(bb);
+
+			if (occupancy & bb)
+				break;
+		}
+	}
+
+	return attacks;
+}
+
+uint64_t random_sparse(uint64_t& seed)
+{
+	uint64_t r[3];
+	for (uint8_t i = 0; i < 3; i++)
+	{
+		seed ^= seed >> 12;
+		seed ^= seed << 25;
+		seed ^= seed >> 27;
+		r[i] = seed * 2685821657736338717ULL;
+	}
+	return r[0] & r[1] & r[2];
+}
+
+void init_magics(Magic magics[64], bitboard_t* table, const int8_t directions[4][2])
+{
+	bitboard_t occupancy[4096], reference[4096];
+#if !defined(USE_PEXT)
+	int epoch[4096] = {}, count = 0;
+#endif
+
+	for (uint8_t square = 0; square < 64; square++)
+	{
+		Magic& m = magics[square];
+
+		bitboard_t edges = ((RANK_1 | RANK_8) & ~(RANK_1 << (square / 8 * 8))) | ((FILE_A | FILE_H) & ~(FILE_A << (square % 8)));
+
+		m.mask = sliding_attacks(directions, square, 0) & ~edges;
+		m.shift = 64 - popcount(m.mask);
+		m.attacks = square == 0 ? table : magics[square - 1].attacks + (1 << (64 - magics[square - 1].shift));
+
+		int size = 0;
+		bitboard_t b = 0;
+		do
+		{
+			occupancy[size] = b;
+			reference[size] = sliding_attacks(directions, square, b);
+			size++;
+			b = (b - m.mask) & m.mask;
+		} while (b);
+
+#if defined(USE_PEXT)
+		for (int i = 0; i < size; i++)
+			m.attacks[m.index(occupancy[i])] = reference[i];
+#else
+		const uint64_t seeds[8] = { 728, 10316, 55013, 32803, 12281, 15100, 16645, 255 };
+		uint64_t seed = seeds[square / 8];
+
+		for (int i = 0; i < size; )
+		{
+			for (m.magic = 0; popcount((m.magic * m.mask) >> 56) < 6; )
+				m.magic = random_sparse(seed);
+
+			for (count++, i = 0; i < size; i++)
+			{
+				unsigned int index = m.index(occupancy[i]);
+
+				if (epoch[index] < count)
+				{
+					epoch[index] = count;
+					m.attacks[index] = reference[i];
+				}
+				else if (m.attacks[index] != reference[i])
+					break;
+			}
+		}
+#endif
+	}
+}
+
+void init_bitboards()
+{
+	const int8_t rook_directions[4][2] = { { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 } };
+	const int8_t bishop_directions[4][2] = { { 1, 1 }, { 1, -1 }, { -1, 1 }, { -1, -1 } };
+
+	const int8_t knight_steps[8][2] = { { 1, 2 }, { 2, 1 }, { -1, 2 }, { -2, 1 }, { 1, -2 }, { 2, -1 }, { -1, -2 }, { -2, -1 } };
+
+	for (uint8_t square = 0; square < 64; square++)
+	{
+		knight_attacks[square] = 0;
+		for (uint8_t i = 0; i < 8; i++)
+			knight_attacks[square] |= step_bb(square, knight_steps[i][0], knight_steps[i][1]);
+
+		king_attacks[square] = 0;
+		for (int8_t dy = -1; dy <= 1; dy++)
+			for (int8_t dx = -1; dx <= 1; dx++)
+				if (dx != 0 || dy != 0)
+					king_attacks[square] |= step_bb(square, dx, dy);
+
+		pawn_attacks[0][square] = step_bb(square, -1, 1) | step_bb(square, 1, 1);
+		pawn_attacks[1][square] = step_bb(square, -1, -1) | step_bb(square, 1, -1);
+	}
+
+	init_magics(rook_magics, rook_table, rook_directions);
+	init_magics(bishop_magics, bishop_table, bishop_directions);
+
+	for (uint8_t s1 = 0; s1 < 64; s1++)
+	{
+		for (uint8_t s2 = 0; s2 < 64; s2++)
+		{
+			between_bb[s1][s2] = 0;
+			line_bb[s1][s2] = 0;
+
+			if (rook_attacks(s1, 0) & square_bb(s2))
+			{
+				between_bb[s1][s2] = rook_attacks(s1, square_bb(s2)) & rook_attacks(s2, square_bb(s1));
+				line_bb[s1][s2] = (rook_attacks(s1, 0) & rook_attacks(s2, 0)) | square_bb(s1) | square_bb(s2);
+			}
+			else if (bishop_attacks(s1, 0) & square_bb(s2))
+			{
+				between_bb[s1][s2] = bishop_attacks(s1, square_bb(s2)) & bishop_attacks(s2, square_bb(s1));
+				line_bb[s1][s2] = (bishop_attacks(s1, 0) & bishop_attacks(s2, 0)) | square_bb(s1) | square_bb(s2);
+			}
+		}
+	}
+}
+
+struct BitboardsInit
+{
+	BitboardsInit()
+	{
+		init_bitboards();
+	}
+} bitboards_init;
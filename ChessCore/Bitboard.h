@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#if defined(USE_PEXT)
+#include <immintrin.h>
+#endif
+
+typedef uint64_t bitboard_t;
+
+const bitboard_t FILE_A = 0x0101010101010101ULL;
+const bitboard_t FILE_H = FILE_A << 7;
+const bitboard_t RANK_1 = 0xFFULL;
+const bitboard_t RANK_8 = RANK_1 << 56;
+const bitboard_t LIGHT_SQUARES = 0x55AA55AA55AA55AAULL;
+const bitboard_t DARK_SQUARES = ~LIGHT_SQUARES;
+
+inline bitboard_t square_bb(uint8_t square)
+{
+	return 1ULL << square;
+}
+
+inline int popcount(bitboard_t bb)
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+	return (int)__popcnt64(bb);
+#elif defined(_MSC_VER)
+	return (int)(__popcnt((unsigned int)bb) + __popcnt((unsigned int)(bb >> 32)));
+#else
+	return __builtin_popcountll(bb);
+#endif
+}
+
+inline uint8_t lsb(bitboard_t bb)
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+	unsigned long index;
+	_BitScanForward64(&index, bb);
+	return (uint8_t)index;
+#elif defined(_MSC_VER)
+	unsigned long index;
+	if (_BitScanForward(&index, (unsigned long)bb))
+		return (uint8_t)index;
+	_BitScanForward(&index, (unsigned long)(bb >> 32));
+	return (uint8_t)(index + 32);
+#else
+	return (uint8_t)__builtin_ctzll(bb);
+#endif
+}
+
+inline uint8_t pop_lsb(bitboard_t& bb)
+{
+	uint8_t square = lsb(bb);
+	bb &= bb - 1;
+	return square;
+}
+
+// Slider lookups use magic multiplication by default. Define USE_PEXT on
+// BMI2 CPUs to index the same tables with pext instead.
+struct Magic
+{
+	bitboard_t mask;
+	bitboard_t magic;
+	bitboard_t* attacks;
+	uint8_t shift;
+
+	unsigned int index(bitboard_t occupancy) const
+	{
+#if defined(USE_PEXT)
+		return (unsigned int)_pext_u64(occupancy, this->mask);
+#else
+		return (unsigned int)(((occupancy & this->mask) * this->magic) >> this->shift);
+#endif
+	}
+};
+
+extern Magic rook_magics[64];
+extern Magic bishop_magics[64];
+
+extern bitboard_t knight_attacks[64];
+extern bitboard_t king_attacks[64];
+extern bitboard_t pawn_attacks[2][64];
+
+// Squares strictly between two squares on a common line, and the whole line
+// through them. Both are empty for squares that share no line.
+extern bitboard_t between_bb[64][64];
+extern bitboard_t line_bb[64][64];
+
+inline bitboard_t rook_attacks(uint8_t square, bitboard_t occupancy)
+{
+	const Magic& m = rook_magics[square];
+	return m.attacks[m.index(occupancy)];
+}
+
+inline bitboard_t bishop_attacks(uint8_t square, bitboard_t occupancy)
+{
+	const Magic& m = bishop_magics[square];
+	return m.attacks[m.index(occupancy)];
+}
@@ -0,0 +1,263 @@
+#include "Board.h"
+#include <algorithm>
+
+Board::Board()
+{
+	for (uint8_t i = 0; i < 12; i++)
+		this->bitboards[i] = 0;
+
+	this->white_occupancy = 0;
+	this->black_occupancy = 0;
+
+	this->key = 0;
+	this->pawn_key = 0;
+
+	this->mg_score = 0;
+	this->eg_score = 0;
+	this->phase = 0;
+}
+
+bool Board::getFigure(pos_t pos)
+{
+	return this->getOccupancy() & square_bb(to_square(pos));
+}
+
+bool Board::getFigure(pos_t pos, Figure& figure)
+{
+	uint8_t square = to_square(pos);
+
+	figure = this->figures[square];
+	return this->getOccupancy() & square_bb(square);
+}
+
+void Board::setFigure(pos_t pos, Figure figure)
+{
+	this->delFigure(pos);
+
+	uint8_t square = to_square(pos);
+
+	this->figures[square] = figure;
+	this->bitboards[figure] |= square_bb(square);
+	this->key ^= zobrist_pieces[figure][square];
+	if (figure == wP || figure == bP)
+		this->pawn_key ^= zobrist_pieces[figure][square];
+
+	this->mg_score += piece_square_mg[figure][square];
+	this->eg_score += piece_square_eg[figure][square];
+	this->phase += phase_weights[figure];
+
+	if (nnue_enabled())
+		this->updateAccumulator(figure, square, true);
+
+	if (color(figure))
+		this->white_occupancy |= square_bb(square);
+	else
+		this->black_occupancy |= square_bb(square);
+}
+
+void Board::moveFigure(pos_t from, pos_t to)
+{
+	Figure figure = this->figures[to_square(from)];
+
+	this->delFigure(from);
+	this->setFigure(to, figure);
+}
+
+void Board::delFigure(pos_t pos)
+{
+	uint8_t square = to_square(pos);
+
+	if (!(this->getOccupancy() & square_bb(square)))
+		return;
+
+	this->bitboards[this->figures[square]] &= ~square_bb(square);
+	this->key ^= zobrist_pieces[this->figures[square]][square];
+	if (this->figures[square] == wP || this->figures[square] == bP)
+		this->pawn_key ^= zobrist_pieces[this->figures[square]][square];
+
+	this->mg_score -= piece_square_mg[this->figures[square]][square];
+	this->eg_score -= piece_square_eg[this->figures[square]][square];
+	this->phase -= phase_weights[this->figures[square]];
+
+	if (nnue_enabled())
+		this->updateAccumulator(this->figures[square], square, false);
+
+	this->white_occupancy &= ~square_bb(square);
+	this->black_occupancy &= ~square_bb(square);
+}
+
+pos_t Board::findKing(bool color)
+{
+	return to_pos(lsb(this->bitboards[color ? wK : bK]));
+}
+
+bitboard_t Board::getBitboard(Figure figure)
+{
+	return this->bitboards[figure];
+}
+
+bitboard_t Board::getOccupancy(bool color)
+{
+	return color ? this->white_occupancy : this->black_occupancy;
+}
+
+bitboard_t Board::getOccupancy()
+{
+	return this->white_occupancy | this->black_occupancy;
+}
+
+bitboard_t Board::getAttacks(bool color)
+{
+	bitboard_t occupancy = this->getOccupancy();
+
+	bitboard_t pawns = this->bitboards[color ? wP : bP];
+	bitboard_t attacked;
+
+	if (color)
+		attacked = ((pawns & ~FILE_A) << 7) | ((pawns & ~FILE_H) << 9);
+	else
+		attacked = ((pawns & ~FILE_A) >> 9) | ((pawns & ~FILE_H) >> 7);
+
+	bitboard_t pieces = this->getOccupancy(color) & ~pawns;
+	while (pieces)
+	{
+		uint8_t square = pop_lsb(pieces);
+		attacked |= attacks(this->figures[square], square, occupancy);
+	}
+
+	return attacked;
+}
+
+// Pieces of both colors that attack the square with the given occupancy.
+bitboard_t Board::getAttackers(uint8_t square, bitboard_t occupancy)
+{
+	bitboard_t* bb = this->bitboards;
+
+	return (pawn_attacks[1][square] & bb[wP]) | (pawn_attacks[0][square] & bb[bP]) |
+		(knight_attacks[square] & (bb[wN] | bb[bN])) |
+		(king_attacks[square] & (bb[wK] | bb[bK])) |
+		(bishop_attacks(square, occupancy) & (bb[wB] | bb[bB] | bb[wQ] | bb[bQ])) |
+		(rook_attacks(square, occupancy) & (bb[wR] | bb[bR] | bb[wQ] | bb[bQ]));
+}
+
+float Board::getPieceSquareScore()
+{
+	int phase = std::min(this->phase, MAX_PHASE);
+
+	return (this->mg_score * phase + this->eg_score * (MAX_PHASE - phase)) / (MAX_PHASE * 100.0f);
+}
+
+NnueAccumulator& Board::getAccumulator()
+{
+	for (uint8_t perspective = 0; perspective < 2; perspective++)
+	{
+		if (this->accumulator.computed[perspective])
+			continue;
+
+		bool side = perspective == 0;
+		uint8_t king = lsb(this->bitboards[side ? wK : bK]);
+
+		nnue_reset(this->accumulator, side);
+
+		bitboard_t pieces = this->getOccupancy() & ~(this->bitboards[wK] | this->bitboards[bK]);
+		while (pieces)
+		{
+			uint8_t square = pop_lsb(pieces);
+			nnue_add_feature(this->accumulator, side, nnue_feature(side, king, this->figures[square], square));
+		}
+
+		this->accumulator.computed[perspective] = true;
+	}
+
+	return this->accumulator;
+}
+
+void Board::saveAccumulator(bool perspective, NnueHalfAccumulator& saved)
+{
+	std::copy(this->accumulator.values[!perspective], this->accumulator.values[!perspective] + NNUE_HALF_DIMENSIONS, saved.values);
+	saved.computed = this->accumulator.computed[!perspective];
+}
+
+void Board::restoreAccumulator(bool perspective, NnueHalfAccumulator& saved)
+{
+	std::copy(saved.values, saved.values + NNUE_HALF_DIMENSIONS, this->accumulator.values[!perspective]);
+	this->accumulator.computed[!perspective] = saved.computed;
+}
+
+uint64_t Board::getKey()
+{
+	return this->key;
+}
+
+uint64_t Board::getPawnKey()
+{
+	return this->pawn_key;
+}
+
+void Board::hashSide()
+{
+	this->key ^= zobrist_side;
+}
+
+void Board::hashCastling(uint8_t rights)
+{
+	for (uint8_t i = 0; i < 4; i++)
+	{
+		if (rights & (1 << i))
+			this->key ^= zobrist_castling[i];
+	}
+}
+
+void Board::hashEnPassant(uint8_t file)
+{
+	if (file < 8)
+		this->key ^= zobrist_en_passant[file];
+}
+
+void Board::updateAccumulator(Figure figure, uint8_t square, bool add)
+{
+	if (figure == wK || figure == bK)
+	{
+		this->accumulator.computed[figure == bK] = false;
+		return;
+	}
+
+	for (uint8_t perspective = 0; perspective < 2; perspective++)
+	{
+		if (!this->accumulator.computed[perspective])
+			continue;
+
+		bool side = perspective == 0;
+		int feature = nnue_feature(side, lsb(this->bitboards[side ? wK : bK]), figure, square);
+
+		if (add)
+			nnue_add_feature(this->accumulator, side, feature);
+		else
+			nnue_sub_feature(this->accumulator, side, feature);
+	}
+}
+
+Board Board::copy()
+{
+	Board copy;
+
+	for (uint8_t i = 0; i < 12; i++)
+		copy.bitboards[i] = this->bitboards[i];
+
+	for (uint8_t square = 0; square < 64; square++)
+		copy.figures[square] = this->figures[square];
+
+	copy.white_occupancy = this->white_occupancy;
+	copy.black_occupancy = this->black_occupancy;
+
+	copy.key = this->key;
+	copy.pawn_key = this->pawn_key;
+
+	copy.mg_score = this->mg_score;
+	copy.eg_score = this->eg_score;
+	copy.phase = this->phase;
+
+	copy.accumulator = this->accumulator;
+
+	return copy;
+}
\ No newline at end of file
@@ -0,0 +1,160 @@
+#pragma once
+
+#include "Bitboard.h"
+#include "Nnue.h"
+#include "PieceSquare.h"
+#include "Zobrist.h"
+
+enum Figure : uint8_t
+{
+	wK,
+	wQ,
+	wR,
+	wB,
+	wN,
+	wP,
+
+	bK,
+	bQ,
+	bR,
+	bB,
+	bN,
+	bP
+};
+
+struct pos_t
+{
+	pos_t() : x(0), y(0) {}
+	pos_t(uint8_t x, uint8_t y) : x(x), y(y) {}
+
+	uint8_t x;
+	uint8_t y;
+};
+
+inline bool operator== (pos_t pos1, pos_t pos2)
+{
+	return pos1.x == pos2.x && pos1.y == pos2.y;
+}
+
+inline bool operator!= (pos_t pos1, pos_t pos2)
+{
+	return !(pos1 == pos2);
+}
+
+inline pos_t operator- (pos_t pos1, pos_t pos2)
+{
+	return pos_t(pos1.x - pos2.x, pos1.y - pos2.y);
+}
+
+inline bool color(Figure figure)
+{
+	return (int)figure < 6;
+}
+
+inline uint8_t fscore(Figure figure)
+{
+	switch (figure % 6)
+	{
+	case 0:
+		return 255;
+	case 1:
+		return 9;
+	case 2:
+		return 5;
+	case 3:
+		return 3;
+	case 4:
+		return 3;
+	default:
+		return 1;
+	}
+}
+
+inline bitboard_t attacks(Figure figure, uint8_t square, bitboard_t occupancy)
+{
+	switch (figure % 6)
+	{
+	case wK:
+		return king_attacks[square];
+	case wQ:
+		return rook_attacks(square, occupancy) | bishop_attacks(square, occupancy);
+	case wR:
+		return rook_attacks(square, occupancy);
+	case wB:
+		return bishop_attacks(square, occupancy);
+	case wN:
+		return knight_attacks[square];
+	default:
+		return pawn_attacks[!color(figure)][square];
+	}
+}
+
+inline uint8_t to_square(pos_t pos)
+{
+	return pos.y * 8 + pos.x;
+}
+
+inline pos_t to_pos(uint8_t square)
+{
+	return pos_t(square % 8, square / 8);
+}
+
+class Board
+{
+public:
+	Board();
+
+	bool getFigure(pos_t pos);
+	bool getFigure(pos_t pos, Figure& figure);
+	void setFigure(pos_t pos, Figure figure);
+
+	void moveFigure(pos_t from, pos_t to);
+	void delFigure(pos_t pos);
+
+	pos_t findKing(bool color);
+
+	bitboard_t getBitboard(Figure figure);
+	bitboard_t getOccupancy(bool color);
+	bitboard_t getOccupancy();
+
+	bitboard_t getAttacks(bool color);
+	bitboard_t getAttackers(uint8_t square, bitboard_t occupancy);
+
+	// Material and piece-square score tapered by the game phase, kept up to
+	// date by setFigure and delFigure.
+	float getPieceSquareScore();
+
+	// Network accumulator with any perspective invalidated by a king move
+	// recomputed first. Only maintained while a network is loaded.
+	NnueAccumulator& getAccumulator();
+
+	// One perspective of the accumulator as it is, for saving around the
+	// king moves that invalidate it.
+	void saveAccumulator(bool perspective, NnueHalfAccumulator& saved);
+	void restoreAccumulator(bool perspective, NnueHalfAccumulator& saved);
+
+	uint64_t getKey();
+	uint64_t getPawnKey();
+	void hashSide();
+	void hashCastling(uint8_t rights);
+	void hashEnPassant(uint8_t file);
+
+	Board copy();
+
+private:
+	bitboard_t bitboards[12];
+	bitboard_t white_occupancy, black_occupancy;
+
+	Figure figures[64];
+
+	uint64_t key;
+	uint64_t pawn_key;
+
+	int mg_score;
+	int eg_score;
+	int phase;
+
+	NnueAccumulator accumulator;
+
+	void updateAccumulator(Figure figure, uint8_t square, bool add);
+};
\ No newline at end of file
@@ -0,0 +1,1216 @@
+#include "ChessRules.h"
+#include "PawnTable.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+char to_char(Figure figure)
+{
+	switch (figure % 6)
+	{
+	case 0:
+		return 'K';
+	case 1:
+		return 'Q';
+	case 2:
+		return 'R';
+	case 3:
+		return 'B';
+	case 4:
+		return 'N';
+	default:
+		return 'P';
+	}
+}
+
+std::string to_string(Ending ending)
+{
+	switch (ending)
+	{
+	case WHITE_WIN:
+		return "White win";
+	case BLACK_WIN:
+		return "Black win";
+	case STALEMATE:
+		return "Stalemate";
+	case IMPOSSIBILITY:
+		return "Impossibility of checkmate";
+	default:
+		return "";
+	}
+}
+
+std::string to_string(Move move)
+{
+	std::string str;
+
+	if (move.short_castling)
+		str = "0-0";
+	else if (move.long_castling)
+		str = "0-0-0";
+	else
+	{
+		if (move.figure != wP && move.figure != bP)
+			str += to_char(move.figure);
+
+		str += std::string(1, (char)(move.from.x + 'a')) + std::to_string(move.from.y + 1) + std::string(1, (move.capture ? 'x' : '-')) + std::string(1, (char)(move.to.x + 'a')) + std::to_string(move.to.y + 1);
+	}
+
+	if (move.checkmate)
+		str += '#';
+	else if (move.draw)
+		str += '=';
+	else if (move.check)
+		str += '+';
+
+	return str;
+}
+
+std::string to_uci(Move move)
+{
+	std::string str;
+
+	str += (char)(move.from.x + 'a');
+	str += (char)(move.from.y + '1');
+	str += (char)(move.to.x + 'a');
+	str += (char)(move.to.y + '1');
+
+	if (move.promotion)
+		str += (char)std::tolower(to_char(move.promoted));
+
+	return str;
+}
+
+std::string to_uci(move16_t move)
+{
+	std::string str;
+
+	str += (char)(move_from(move) % 8 + 'a');
+	str += (char)(move_from(move) / 8 + '1');
+	str += (char)(move_to(move) % 8 + 'a');
+	str += (char)(move_to(move) / 8 + '1');
+
+	if (is_promotion(move))
+		str += "qrbn"[move_flags(move) & 3];
+
+	return str;
+}
+
+move16_t pack_move(Move move)
+{
+	uint8_t flags = FLAG_QUIET;
+
+	if (move.promotion)
+		flags = (move.capture ? FLAG_CAPTURE_PROMOTION : FLAG_PROMOTION) | (move.promoted % 6 - 1);
+	else if (move.en_passant)
+		flags = FLAG_EN_PASSANT;
+	else if (move.capture)
+		flags = FLAG_CAPTURE;
+	else if (move.short_castling)
+		flags = FLAG_SHORT_CASTLING;
+	else if (move.long_castling)
+		flags = FLAG_LONG_CASTLING;
+	else if ((move.figure == wP || move.figure == bP) && std::abs(move.to.y - move.from.y) == 2)
+		flags = FLAG_DOUBLE_PUSH;
+
+	return make_move16(to_square(move.from), to_square(move.to), flags);
+}
+
+uint8_t en_passant_file(Move move)
+{
+	if ((move.figure == wP || move.figure == bP) && std::abs(move.to.y - move.from.y) == 2)
+		return move.to.x;
+	return 8;
+}
+
+bool operator== (Move move1, Move move2)
+{
+	return (move1.figure == move2.figure) && (move1.from == move2.from) && (move1.to == move2.to) && (move1.promoted == move2.promoted);
+}
+
+// Each search thread evaluates with its own pawn table.
+thread_local PawnTable pawn_table;
+
+//------------------------------------------------------------------------------------
+
+Move::Move() : Move(wK, pos_t(0, 0), pos_t(0, 0)) {}
+
+Move::Move(Figure figure, pos_t from, pos_t to)
+{
+	this->figure = figure;
+	this->from = from;
+	this->to = to;
+
+	this->promoted = figure;
+}
+
+//------------------------------------------------------------------------------------
+
+void CastlingData::updateData(Move& move)
+{
+	if (move.short_castling || move.long_castling)
+	{
+		if (color(move.figure))
+			this->white_castling_done = true;
+		else
+			this->black_castling_done = true;
+	}
+
+	if (move.figure == wK)
+		this->wk_moved = true;
+	else if (move.figure == bK)
+		this->bk_moved = true;
+
+	// A rook that is captured in its corner loses its castling right as well.
+	if (move.from == pos_t(7, 0) || move.to == pos_t(7, 0))
+		this->white_rook_moved[0] = true;
+	if (move.from == pos_t(0, 0) || move.to == pos_t(0, 0))
+		this->white_rook_moved[1] = true;
+	if (move.from == pos_t(7, 7) || move.to == pos_t(7, 7))
+		this->black_rook_moved[0] = true;
+	if (move.from == pos_t(0, 7) || move.to == pos_t(0, 7))
+		this->black_rook_moved[1] = true;
+}
+
+uint8_t CastlingData::getRights()
+{
+	uint8_t rights = 0;
+
+	if (!this->wk_moved && !this->white_castling_done)
+	{
+		if (!this->white_rook_moved[0])
+			rights |= 1;
+		if (!this->white_rook_moved[1])
+			rights |= 2;
+	}
+
+	if (!this->bk_moved && !this->black_castling_done)
+	{
+		if (!this->black_rook_moved[0])
+			rights |= 4;
+		if (!this->black_rook_moved[1])
+			rights |= 8;
+	}
+
+	return rights;
+}
+
+//------------------------------------------------------------------------------------
+
+void ChessRules::makeMove(ChessGameData* data, Move& move, UndoData& undo)
+{
+	ChessRules::makeMove(data, pack_move(move), undo);
+	data->moves.push_back(move);
+}
+
+void ChessRules::unmakeMove(ChessGameData* data, Move& move, UndoData& undo)
+{
+	data->moves.pop_back();
+	ChessRules::unmakeMove(data, pack_move(move), undo);
+}
+
+void ChessRules::makeNullMove(ChessGameData* data, UndoData& undo)
+{
+	undo.prev_move = data->prev_move;
+	undo.checkers = data->checkers;
+	undo.pinned = data->pinned;
+	undo.halfmove_clock = data->halfmove_clock;
+
+	bool turn = !color(data->prev_move.figure);
+	pos_t king = data->board.findKing(turn);
+
+	data->board.hashEnPassant(en_passant_file(data->prev_move));
+
+	data->prev_move = Move(turn ? wK : bK, king, king);
+	data->halfmove_clock++;
+
+	data->board.hashSide();
+
+	ChessRules::findPins(data);
+}
+
+void ChessRules::unmakeNullMove(ChessGameData* data, UndoData& undo)
+{
+	data->board.hashSide();
+
+	data->prev_move = undo.prev_move;
+	data->checkers = undo.checkers;
+	data->pinned = undo.pinned;
+	data->halfmove_clock = undo.halfmove_clock;
+
+	data->board.hashEnPassant(en_passant_file(data->prev_move));
+}
+
+void ChessRules::makeMove(ChessGameData* data, move16_t move, UndoData& undo)
+{
+	Board& board = data->board;
+
+	uint8_t from = move_from(move);
+	uint8_t to = move_to(move);
+	uint8_t flags = move_flags(move);
+
+	Figure figure;
+	board.getFigure(to_pos(from), figure);
+	bool clr = color(figure);
+
+	undo.prev_move = data->prev_move;
+	undo.castling = data->castling;
+	undo.capture = board.getFigure(to_pos(to), undo.captured);
+	undo.white_attacks = data->white_attacks;
+	undo.black_attacks = data->black_attacks;
+	undo.checkers = data->checkers;
+	undo.pinned = data->pinned;
+	undo.halfmove_clock = data->halfmove_clock;
+
+	undo.accumulator_saved = undo.accumulator && nnue_enabled() && (figure == wK || figure == bK);
+	if (undo.accumulator_saved)
+		board.saveAccumulator(clr, *undo.accumulator);
+
+	board.hashEnPassant(en_passant_file(data->prev_move));
+
+	board.moveFigure(to_pos(from), to_pos(to));
+
+	if (flags == FLAG_EN_PASSANT)
+		board.delFigure(to_pos(clr ? to - 8 : to + 8));
+	else if (is_promotion(move))
+		board.setFigure(to_pos(to), (Figure)((clr ? wQ : bQ) + (flags & 3)));
+	else if (flags == FLAG_SHORT_CASTLING)
+		board.moveFigure(to_pos(to + 1), to_pos(to - 1));
+	else if (flags == FLAG_LONG_CASTLING)
+		board.moveFigure(to_pos(to - 2), to_pos(to + 1));
+
+	Move& prev = data->prev_move;
+	prev = Move(figure, to_pos(from), to_pos(to));
+	prev.capture = undo.capture || flags == FLAG_EN_PASSANT;
+	prev.en_passant = flags == FLAG_EN_PASSANT;
+	prev.short_castling = flags == FLAG_SHORT_CASTLING;
+	prev.long_castling = flags == FLAG_LONG_CASTLING;
+	prev.promotion = is_promotion(move);
+	if (prev.promotion)
+		prev.promoted = (Figure)((clr ? wQ : bQ) + (flags & 3));
+
+	data->castling.updateData(prev);
+
+	if (prev.capture || figure == wP || figure == bP)
+		data->halfmove_clock = 0;
+	else
+		data->halfmove_clock++;
+
+	if (!clr)
+		data->fullmove_number++;
+
+	data->ply++;
+
+	board.hashCastling(undo.castling.getRights() ^ data->castling.getRights());
+	board.hashEnPassant(en_passant_file(prev));
+	board.hashSide();
+
+	ChessRules::findAttackedPoses(data);
+
+	prev.check = data->checkers != 0;
+}
+
+void ChessRules::unmakeMove(ChessGameData* data, move16_t move, UndoData& undo)
+{
+	Board& board = data->board;
+
+	uint8_t from = move_from(move);
+	uint8_t to = move_to(move);
+	uint8_t flags = move_flags(move);
+
+	bool clr = color(data->prev_move.figure);
+
+	board.hashSide();
+	board.hashEnPassant(en_passant_file(data->prev_move));
+	board.hashCastling(undo.castling.getRights() ^ data->castling.getRights());
+
+	board.moveFigure(to_pos(to), to_pos(from));
+
+	if (flags == FLAG_EN_PASSANT)
+		board.setFigure(to_pos(clr ? to - 8 : to + 8), clr ? bP : wP);
+	else if (is_promotion(move))
+		board.setFigure(to_pos(from), clr ? wP : bP);
+	else if (flags == FLAG_SHORT_CASTLING)
+		board.moveFigure(to_pos(to - 1), to_pos(to + 1));
+	else if (flags == FLAG_LONG_CASTLING)
+		board.moveFigure(to_pos(to + 1), to_pos(to - 2));
+
+	if (undo.capture)
+		board.setFigure(to_pos(to), undo.captured);
+
+	if (undo.accumulator_saved)
+		board.restoreAccumulator(clr, *undo.accumulator);
+
+	data->prev_move = undo.prev_move;
+	data->castling = undo.castling;
+
+	board.hashEnPassant(en_passant_file(data->prev_move));
+
+	data->white_attacks = undo.white_attacks;
+	data->black_attacks = undo.black_attacks;
+
+	data->checkers = undo.checkers;
+	data->pinned = undo.pinned;
+
+	data->halfmove_clock = undo.halfmove_clock;
+	if (!clr)
+		data->fullmove_number--;
+
+	data->ply--;
+}
+
+Move ChessRules::unpackMove(ChessGameData* data, move16_t move)
+{
+	Figure figure;
+	data->board.getFigure(to_pos(move_from(move)), figure);
+
+	Move result(figure, to_pos(move_from(move)), to_pos(move_to(move)));
+
+	uint8_t flags = move_flags(move);
+
+	result.capture = is_capture(move);
+	result.en_passant = flags == FLAG_EN_PASSANT;
+	result.short_castling = flags == FLAG_SHORT_CASTLING;
+	result.long_castling = flags == FLAG_LONG_CASTLING;
+	result.promotion = is_promotion(move);
+
+	if (result.promotion)
+		result.promoted = (Figure)((color(figure) ? wQ : bQ) + (flags & 3));
+
+	result.check = ChessRules::givesCheck(data, result);
+
+	return result;
+}
+
+float ChessRules::calcScore(ChessGameData* data, bool active, Ending ending)
+{
+	float score = 0.0f;
+
+	if (active && nnue_enabled())
+	{
+		bool turn = !color(data->prev_move.figure);
+
+		// Centipawns from the side to move, to pawns of 11.2.
+		score = nnue_evaluate(data->board.getAccumulator(), turn) * 0.112f;
+		if (!turn)
+			score = -score;
+
+		if (score > 200.0f)
+			score = 200.0f;
+		else if (score < -200.0f)
+			score = -200.0f;
+	}
+	else if (active)
+	{
+		score += data->board.getPieceSquareScore();
+
+		PawnEntry* pawns = pawn_table.probe(data->board);
+		score += pawns->score;
+
+		// Passed pawns whose stop square is free are worth half as much again.
+		bitboard_t occupancy = data->board.getOccupancy();
+		score += popcount((pawns->passed[0] << 8) & ~occupancy) * 1.5f;
+		score -= popcount((pawns->passed[1] >> 8) & ~occupancy) * 1.5f;
+
+		int wcount = popcount(data->white_attacks);
+		int bcount = popcount(data->black_attacks);
+
+		score += wcount * sqrt(wcount) / 4.7f;
+		score -= bcount * sqrt(bcount) / 4.7f;
+
+		score += (float)data->castling.white_castling_done / sqrt(data->ply) * 11.0f;
+		score -= (float)data->castling.black_castling_done / sqrt(data->ply) * 11.0f;
+
+		if (score > 200.0f)
+			score = 200.0f;
+		else if (score < -200.0f)
+			score = -200.0f;
+	}
+	else
+	{
+		if (ending == WHITE_WIN)
+			score = 300.0f;
+		else if (ending == BLACK_WIN)
+			score = -300.0f;
+		else
+			score = 0.0f;
+	}
+
+	return score;
+}
+
+bool ChessRules::checkMove(ChessGameData* data, Move& move)
+{
+	if ((move.from.x >= 8) ||
+		(move.from.y >= 8) ||
+		(move.to.x >= 8) ||
+		(move.to.y >= 8))
+		return false;
+
+	Figure target;
+	move.capture = data->board.getFigure(move.to, target);
+
+	if (move.capture)
+	{
+		if (color(target) == color(move.figure))
+			return false;
+	}
+
+	int8_t dx = move.to.x - move.from.x;
+	int8_t dy = move.to.y - move.from.y;
+
+	if (dx == 0 && dy == 0)
+		return false;
+
+	if (move.figure == wK || move.figure == bK)
+	{
+		if (std::max(std::abs(dx), std::abs(dy)) == 1)
+			return true;
+		if (dy == 0 && !data->prev_move.check)
+		{
+			if (color(move.figure))
+			{
+				if (dx == 2)
+				{
+					if (!data->castling.wk_moved && !data->castling.white_rook_moved[0] && !data->castling.white_castling_done &&
+						!data->board.getFigure(pos_t(5, 0)) && !data->board.getFigure(pos_t(6, 0)) &&
+						!ChessRules::isAttacked(data, pos_t(5, 0), false))
+					{
+						move.short_castling = true;
+						return true;
+					}
+					return false;
+				}
+				else if (dx == -2)
+				{
+					if (!data->castling.wk_moved && !data->castling.white_rook_moved[1] && !data->castling.white_castling_done &&
+						!data->board.getFigure(pos_t(3, 0)) && !data->board.getFigure(pos_t(2, 0)) && !data->board.getFigure(pos_t(1, 0)) &&
+						!ChessRules::isAttacked(data, pos_t(3, 0), false))
+					{
+						move.long_castling = true;
+						return true;
+					}
+					return false;
+				}
+			}
+			else
+			{
+				if (dx == 2)
+				{
+					if (!data->castling.bk_moved && !data->castling.black_rook_moved[0] && !data->castling.black_castling_done &&
+						!data->board.getFigure(pos_t(5, 7)) && !data->board.getFigure(pos_t(6, 7)) &&
+						!ChessRules::isAttacked(data, pos_t(5, 7), true))
+					{
+						move.short_castling = true;
+						return true;
+					}
+					return false;
+				}
+				else if (dx == -2)
+				{
+					if (!data->castling.bk_moved && !data->castling.black_rook_moved[1] && !data->castling.black_castling_done &&
+						!data->board.getFigure(pos_t(3, 7)) && !data->board.getFigure(pos_t(2, 7)) && !data->board.getFigure(pos_t(1, 7)) &&
+						!ChessRules::isAttacked(data, pos_t(3, 7), true))
+					{
+						move.long_castling = true;
+						return true;
+					}
+					return false;
+				}
+			}
+		}
+	}
+	else if (move.figure == wP)
+	{
+		move.promotion = (move.to.y == 7);
+		move.promoted = move.promotion ? wQ : wP;
+
+		if (move.capture)
+		{
+			return std::abs(dx) == 1 && dy == 1;
+		}
+		else
+		{
+			if (data->prev_move.figure == bP && data->prev_move.to - data->prev_move.from == pos_t(0, -2) && std::abs(dx) == 1 && dy == 1 && move.to == pos_t(data->prev_move.to.x, data->prev_move.to.y + 1))
+			{
+				move.capture = true;
+				move.en_passant = true;
+				return true;
+			}
+
+			if (dx != 0)
+				return false;
+
+			if (move.from.y == 1)
+			{
+				return (dy == 1) || (dy == 2 && !data->board.getFigure(pos_t(move.from.x, 2)) && !data->board.getFigure(pos_t(move.from.x, 3)));
+			}
+			else
+			{
+
+				return dy == 1;
+			}
+		}
+	}
+	else if (move.figure == bP)
+	{
+		move.promotion = (move.to.y == 0);
+		move.promoted = move.promotion ? bQ : bP;
+
+		if (move.capture)
+		{
+			return std::abs(dx) == 1 && dy == -1;
+		}
+		else
+		{
+			if (data->prev_move.figure == wP && data->prev_move.to - data->prev_move.from == pos_t(0, 2) && std::abs(dx) == 1 && dy == -1 && move.to == pos_t(data->prev_move.to.x, data->prev_move.to.y - 1))
+			{
+				move.capture = true;
+				move.en_passant = true;
+				return true;
+			}
+
+			if (dx != 0)
+				return false;
+
+			if (move.from.y == 6)
+			{
+				return (dy == -1) || (dy == -2 && !data->board.getFigure(pos_t(move.from.x, 5)) && !data->board.getFigure(pos_t(move.from.x, 4)));
+			}
+			else
+			{
+				return dy == -1;
+			}
+		}
+	}
+	else
+		return attacks(move.figure, to_square(move.from), data->board.getOccupancy()) & square_bb(to_square(move.to));
+	return false;
+}
+
+bool ChessRules::checkCheck(ChessGameData* data, bool& wk_check, bool& bk_check)
+{
+	pos_t wpos = data->board.findKing(true);
+	pos_t bpos = data->board.findKing(false);
+
+	wk_check = ChessRules::isAttacked(data, wpos, false);
+	bk_check = ChessRules::isAttacked(data, bpos, true);
+
+	return wk_check || bk_check;
+}
+
+bool ChessRules::isAvailable(ChessGameData* data, Move& move)
+{
+	if (!ChessRules::isLegal(data, move))
+		return false;
+
+	move.check = ChessRules::givesCheck(data, move);
+	return true;
+}
+
+bool ChessRules::isLegal(ChessGameData* data, Move& move)
+{
+	bool clr = color(move.figure);
+
+	uint8_t king = lsb(data->board.getBitboard(clr ? wK : bK));
+	uint8_t from = to_square(move.from);
+	uint8_t to = to_square(move.to);
+
+	bitboard_t occupancy = data->board.getOccupancy();
+	bitboard_t enemies = data->board.getOccupancy(!clr);
+
+	// The king may not step along the ray of a slider it is moving away from.
+	if (move.figure == wK || move.figure == bK)
+		return !(data->board.getAttackers(to, occupancy ^ square_bb(from)) & enemies);
+
+	// En passant removes two pieces from a line, so it is played out.
+	if (move.en_passant)
+	{
+		bitboard_t captured = square_bb(to_square(pos_t(move.to.x, move.from.y)));
+		occupancy ^= square_bb(from) | square_bb(to) | captured;
+
+		return !(data->board.getAttackers(king, occupancy) & enemies & ~captured);
+	}
+
+	if (data->checkers)
+	{
+		if (data->checkers & (data->checkers - 1))
+			return false;
+
+		if (!(square_bb(to) & (between_bb[king][lsb(data->checkers)] | data->checkers)))
+			return false;
+	}
+
+	return !(data->pinned & square_bb(from)) || (line_bb[king][from] & square_bb(to));
+}
+
+bool ChessRules::givesCheck(ChessGameData* data, Move& move)
+{
+	bool clr = color(move.figure);
+
+	bitboard_t king = data->board.getBitboard(clr ? bK : wK);
+	uint8_t to = to_square(move.to);
+
+	bitboard_t moved = square_bb(to_square(move.from));
+	bitboard_t occupancy = (data->board.getOccupancy() ^ moved) | square_bb(to);
+
+	Figure figure = move.promotion ? move.promoted : move.figure;
+	uint8_t square = to;
+
+	if (move.en_passant)
+		occupancy ^= square_bb(to_square(pos_t(move.to.x, move.from.y)));
+	else if (move.short_castling || move.long_castling)
+	{
+		uint8_t rook_from = to_square(pos_t(move.short_castling ? 7 : 0, move.from.y));
+		uint8_t rook_to = to_square(pos_t(move.short_castling ? 5 : 3, move.from.y));
+
+		occupancy ^= square_bb(rook_from) | square_bb(rook_to);
+		moved |= square_bb(rook_from);
+
+		figure = clr ? wR : bR;
+		square = rook_to;
+	}
+
+	if (attacks(figure, square, occupancy) & king)
+		return true;
+
+	// Discovered checks by the sliders that stayed in place.
+	uint8_t ksq = lsb(king);
+
+	bitboard_t queens = data->board.getBitboard(clr ? wQ : bQ);
+	bitboard_t sliders = (bishop_attacks(ksq, occupancy) & (data->board.getBitboard(clr ? wB : bB) | queens)) |
+		(rook_attacks(ksq, occupancy) & (data->board.getBitboard(clr ? wR : bR) | queens));
+
+	return (sliders & ~moved) != 0;
+}
+
+bool ChessRules::isValid(ChessGameData* data, move16_t move)
+{
+	pos_t from = to_pos(move_from(move));
+
+	Figure figure;
+	if (!data->board.getFigure(from, figure) || color(figure) == color(data->prev_move.figure))
+		return false;
+
+	Move candidate(figure, from, to_pos(move_to(move)));
+	if (!ChessRules::checkMove(data, candidate))
+		return false;
+
+	if (candidate.promotion)
+		candidate.promoted = (Figure)(candidate.promoted + (move_flags(move) & 3));
+
+	return pack_move(candidate) == move && ChessRules::isLegal(data, candidate);
+}
+
+void ChessRules::generateMoves(ChessGameData* data, MoveList& list, bitboard_t mask)
+{
+	bool turn = !color(data->prev_move.figure);
+	Board& board = data->board;
+
+	uint8_t king = lsb(board.getBitboard(turn ? wK : bK));
+
+	bitboard_t occupancy = board.getOccupancy();
+	bitboard_t own = board.getOccupancy(turn);
+	bitboard_t enemies = board.getOccupancy(!turn);
+
+	bitboard_t check_mask = ~0ULL;
+	if (data->checkers)
+		check_mask = (data->checkers & (data->checkers - 1)) ? 0 : between_bb[king][lsb(data->checkers)] | data->checkers;
+
+	uint8_t file = en_passant_file(data->prev_move);
+	bitboard_t en_passant = file < 8 ? square_bb(to_square(pos_t(file, turn ? 5 : 2))) : 0;
+
+	uint8_t rank = turn ? 0 : 56;
+	uint8_t rights = data->castling.getRights() >> (turn ? 0 : 2);
+
+	bitboard_t side = own;
+	while (side)
+	{
+		uint8_t from = pop_lsb(side);
+
+		Figure figure;
+		board.getFigure(to_pos(from), figure);
+
+		bitboard_t targets;
+
+		if (figure == wK || figure == bK)
+		{
+			targets = king_attacks[from] & ~own;
+
+			if (!data->checkers && from == rank + 4)
+			{
+				bitboard_t rooks = board.getBitboard(turn ? wR : bR);
+
+				if ((rights & 1) && (rooks & square_bb(rank + 7)) && !(occupancy & (square_bb(rank + 5) | square_bb(rank + 6))) && !(board.getAttackers(rank + 5, occupancy) & enemies))
+					targets |= square_bb(rank + 6);
+				if ((rights & 2) && (rooks & square_bb(rank)) && !(occupancy & (square_bb(rank + 1) | square_bb(rank + 2) | square_bb(rank + 3))) && !(board.getAttackers(rank + 3, occupancy) & enemies))
+					targets |= square_bb(rank + 2);
+			}
+
+			targets &= mask;
+
+			while (targets)
+			{
+				uint8_t to = pop_lsb(targets);
+
+				if (board.getAttackers(to, occupancy ^ square_bb(from)) & enemies)
+					continue;
+
+				if (to == from + 2)
+					list.add(make_move16(from, to, FLAG_SHORT_CASTLING));
+				else if (to + 2 == from)
+					list.add(make_move16(from, to, FLAG_LONG_CASTLING));
+				else
+					list.add(make_move16(from, to, (enemies & square_bb(to)) ? FLAG_CAPTURE : FLAG_QUIET));
+			}
+		}
+		else if (figure == wP || figure == bP)
+		{
+			int forward = turn ? 8 : -8;
+			uint8_t push = from + forward;
+
+			targets = pawn_attacks[!turn][from] & (enemies | en_passant);
+
+			if (!(occupancy & square_bb(push)))
+			{
+				targets |= square_bb(push);
+
+				if (from / 8 == (turn ? 1 : 6) && !(occupancy & square_bb(push + forward)))
+					targets |= square_bb(push + forward);
+			}
+
+			targets &= mask;
+
+			while (targets)
+			{
+				uint8_t to = pop_lsb(targets);
+				bitboard_t target = square_bb(to);
+
+				if (target & en_passant)
+				{
+					bitboard_t captured = square_bb(to - forward);
+
+					if (!(board.getAttackers(king, occupancy ^ square_bb(from) ^ target ^ captured) & enemies & ~captured))
+						list.add(make_move16(from, to, FLAG_EN_PASSANT));
+					continue;
+				}
+
+				if (!(target & check_mask) || ((data->pinned & square_bb(from)) && !(line_bb[king][from] & target)))
+					continue;
+
+				uint8_t capture = (enemies & target) ? FLAG_CAPTURE : FLAG_QUIET;
+
+				if (to / 8 == (turn ? 7 : 0))
+				{
+					for (uint8_t i = 0; i < 4; i++)
+						list.add(make_move16(from, to, FLAG_PROMOTION | capture | i));
+				}
+				else
+					list.add(make_move16(from, to, to == push + forward ? (uint8_t)FLAG_DOUBLE_PUSH : capture));
+			}
+		}
+		else
+		{
+			targets = attacks(figure, from, occupancy) & ~own & mask & check_mask;
+
+			if (data->pinned & square_bb(from))
+				targets &= line_bb[king][from];
+
+			while (targets)
+			{
+				uint8_t to = pop_lsb(targets);
+				list.add(make_move16(from, to, (enemies & square_bb(to)) ? FLAG_CAPTURE : FLAG_QUIET));
+			}
+		}
+	}
+}
+
+std::vector<Move> ChessRules::findPossibleMoves(ChessGameData* data, pos_t pos, bitboard_t mask)
+{
+	std::vector<Move> moves;
+
+	Figure figure;
+	data->board.getFigure(pos, figure);
+
+	uint8_t square = to_square(pos);
+	bitboard_t targets = attacks(figure, square, data->board.getOccupancy()) & ~data->board.getOccupancy(color(figure));
+
+	if (figure == wP)
+		targets |= square_bb(square + 8) | (pos.y == 1 ? square_bb(square + 16) : 0);
+	else if (figure == bP)
+		targets |= square_bb(square - 8) | (pos.y == 6 ? square_bb(square - 16) : 0);
+	else if ((figure == wK || figure == bK) && pos.x == 4)
+		targets |= square_bb(square + 2) | square_bb(square - 2);
+
+	targets &= mask;
+
+	// Pieces other than the king and pawns, whose en passant captures may
+	// resolve a check off the check mask, can be restricted up front.
+	if (figure != wK && figure != bK && figure != wP && figure != bP)
+	{
+		uint8_t king = lsb(data->board.getBitboard(color(figure) ? wK : bK));
+
+		if (data->checkers)
+			targets &= (data->checkers & (data->checkers - 1)) ? 0 : between_bb[king][lsb(data->checkers)] | data->checkers;
+		if (data->pinned & square_bb(square))
+			targets &= line_bb[king][square];
+	}
+
+	while (targets)
+	{
+		Move move(figure, pos, to_pos(pop_lsb(targets)));
+		if (!checkMove(data, move) || !isAvailable(data, move))
+			continue;
+
+		moves.push_back(move);
+
+		// Underpromotions follow the queen one; each may differ in giving check.
+		for (uint8_t i = 1; move.promotion && i < 4; i++)
+		{
+			Move under = move;
+			under.promoted = (Figure)(move.promoted + i);
+			isAvailable(data, under);
+			moves.push_back(under);
+		}
+	}
+
+	return moves;
+}
+
+void ChessRules::findAttackedPoses(ChessGameData* data)
+{
+	data->white_attacks = data->board.getAttacks(true);
+	data->black_attacks = data->board.getAttacks(false);
+
+	ChessRules::findPins(data);
+}
+
+void ChessRules::findPins(ChessGameData* data)
+{
+	bool turn = !color(data->prev_move.figure);
+
+	uint8_t king = lsb(data->board.getBitboard(turn ? wK : bK));
+	bitboard_t occupancy = data->board.getOccupancy();
+
+	data->checkers = data->board.getAttackers(king, occupancy) & data->board.getOccupancy(!turn);
+	data->pinned = 0;
+
+	bitboard_t queens = data->board.getBitboard(turn ? bQ : wQ);
+	bitboard_t snipers = (rook_attacks(king, 0) & (data->board.getBitboard(turn ? bR : wR) | queens)) |
+		(bishop_attacks(king, 0) & (data->board.getBitboard(turn ? bB : wB) | queens));
+
+	while (snipers)
+	{
+		bitboard_t between = between_bb[king][pop_lsb(snipers)] & occupancy;
+
+		if (between && !(between & (between - 1)) && (between & data->board.getOccupancy(turn)))
+			data->pinned |= between;
+	}
+}
+
+bool ChessRules::isAttacked(ChessGameData* data, pos_t pos, bool color)
+{
+	return (color ? data->white_attacks : data->black_attacks) & square_bb(to_square(pos));
+}
+
+bool ChessRules::checkImpossibility(ChessGameData* data)
+{
+	if (data->board.getBitboard(wP) | data->board.getBitboard(bP) |
+		data->board.getBitboard(wQ) | data->board.getBitboard(bQ) |
+		data->board.getBitboard(wR) | data->board.getBitboard(bR))
+		return false;
+
+	bool wb[] { (data->board.getBitboard(wB) & LIGHT_SQUARES) != 0, (data->board.getBitboard(wB) & DARK_SQUARES) != 0 };
+	bool bb[] { (data->board.getBitboard(bB) & LIGHT_SQUARES) != 0, (data->board.getBitboard(bB) & DARK_SQUARES) != 0 };
+
+	uint8_t wknights = popcount(data->board.getBitboard(wN));
+	uint8_t bknights = popcount(data->board.getBitboard(bN));
+
+	bool wcw = false;
+	bool bcw = false;
+
+	if (wknights != 0)
+	{
+		if (wknights == 1)
+			wcw = (wb[0] || wb[1]);
+		else
+			wcw = true;
+	}
+	else
+		wcw = (wb[0] && wb[1]);
+
+	if (bknights != 0)
+	{
+		if (bknights == 1)
+			bcw = (bb[0] || bb[1]);
+		else
+			bcw = true;
+	}
+	else
+		bcw = (bb[0] && bb[1]);
+
+	return !wcw && !bcw;
+}
+
+bool ChessRules::checkEnding(ChessGameData* data, Ending& ending)
+{
+	MoveList list;
+	ChessRules::generateMoves(data, list);
+
+	int mnum = list.size;
+
+	if (data->prev_move.check)
+	{
+		if (mnum == 0)
+		{
+			ending = (Ending)((uint8_t)(!color(data->prev_move.figure)));
+			return true;
+		}
+	}
+	else
+	{
+		if (mnum == 0)
+		{
+			ending = STALEMATE;
+			return true;
+		}
+		if (ChessRules::checkImpossibility(data))
+		{
+			ending = IMPOSSIBILITY;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool ChessRules::parseMove(ChessGameData* data, std::string str, bool turn, Move& move)
+{
+	if (str.size() < 4 || str.size() > 5)
+		return false;
+
+	pos_t from(str[0] - 'a', str[1] - '1');
+	pos_t to(str[2] - 'a', str[3] - '1');
+
+	if (from.x >= 8 || from.y >= 8 || to.x >= 8 || to.y >= 8)
+		return false;
+
+	Figure figure;
+	if (!data->board.getFigure(from, figure) || color(figure) != turn)
+		return false;
+
+	for (Move& candidate : ChessRules::findPossibleMoves(data, from, square_bb(to_square(to))))
+	{
+		// A promotion without a piece letter is taken as a queen promotion.
+		if (candidate.promotion && str.size() == 5 && std::tolower(to_char(candidate.promoted)) != str[4])
+			continue;
+
+		move = candidate;
+		return true;
+	}
+
+	return false;
+}
+
+bool ChessRules::loadFen(ChessGameData* data, const char* fen, bool& turn)
+{
+	const char* symbols = "KQRBNPkqrbnp";
+
+	// Fields are reset one by one so that the move list keeps its capacity
+	// when many positions are loaded into the same ChessGameData.
+	data->board = Board();
+	data->moves.clear();
+	data->ply = 0;
+	data->castling = CastlingData();
+	data->halfmove_clock = 0;
+	data->fullmove_number = 1;
+
+	uint8_t x = 0, y = 7;
+
+	for (; *fen != ' '; fen++)
+	{
+		if (*fen == '\0')
+			return false;
+
+		if (*fen == '/')
+		{
+			if (x != 8 || y == 0)
+				return false;
+			x = 0;
+			y--;
+		}
+		else if (*fen >= '1' && *fen <= '8')
+			x += *fen - '0';
+		else
+		{
+			const char* symbol = std::strchr(symbols, *fen);
+			if (symbol == nullptr || x >= 8)
+				return false;
+
+			data->board.setFigure(pos_t(x, y), (Figure)(symbol - symbols));
+			x++;
+		}
+
+		if (x > 8)
+			return false;
+	}
+
+	if (x != 8 || y != 0 || popcount(data->board.getBitboard(wK)) != 1 || popcount(data->board.getBitboard(bK)) != 1)
+		return false;
+
+	if ((data->board.getBitboard(wP) | data->board.getBitboard(bP)) & (RANK_1 | RANK_8))
+		return false;
+
+	fen++;
+	if (*fen != 'w' && *fen != 'b')
+		return false;
+	turn = *fen++ == 'w';
+
+	while (*fen == ' ')
+		fen++;
+
+	bool rights[4] = { false, false, false, false };
+
+	for (; *fen != ' ' && *fen != '\0'; fen++)
+	{
+		const char* symbol = std::strchr("KQkq", *fen);
+		if (symbol != nullptr)
+			rights[symbol - "KQkq"] = true;
+		else if (*fen != '-')
+			return false;
+	}
+
+	// Rights whose king or rook is not on its home square are dropped, the
+	// move generator relies on both being there.
+	Board& board = data->board;
+
+	data->castling.wk_moved = !(board.getBitboard(wK) & square_bb(4));
+	data->castling.white_rook_moved[0] = !rights[0] || !(board.getBitboard(wR) & square_bb(7));
+	data->castling.white_rook_moved[1] = !rights[1] || !(board.getBitboard(wR) & square_bb(0));
+	data->castling.bk_moved = !(board.getBitboard(bK) & square_bb(60));
+	data->castling.black_rook_moved[0] = !rights[2] || !(board.getBitboard(bR) & square_bb(63));
+	data->castling.black_rook_moved[1] = !rights[3] || !(board.getBitboard(bR) & square_bb(56));
+
+	while (*fen == ' ')
+		fen++;
+
+	// The rules derive en passant and castling legality from the previous
+	// move, so one is made up: a double pawn push or a null king move.
+	uint8_t file = 8;
+
+	if (*fen >= 'a' && *fen <= 'h' && fen[1] == (turn ? '6' : '3'))
+	{
+		file = *fen - 'a';
+		fen += 2;
+	}
+	else if (*fen == '-')
+		fen++;
+	else
+		return false;
+
+	Figure pawn;
+	if (file < 8 && data->board.getFigure(pos_t(file, turn ? 4 : 3), pawn) && pawn == (turn ? bP : wP))
+	{
+		if (turn)
+			data->prev_move = Move(bP, pos_t(file, 6), pos_t(file, 4));
+		else
+			data->prev_move = Move(wP, pos_t(file, 1), pos_t(file, 3));
+	}
+	else
+	{
+		pos_t king = data->board.findKing(!turn);
+		data->prev_move = Move(turn ? bK : wK, king, king);
+	}
+
+	// Move counters are optional, so EPD lines are accepted as well.
+	while (*fen == ' ')
+		fen++;
+
+	if (*fen >= '0' && *fen <= '9')
+	{
+		data->halfmove_clock = (int)std::strtol(fen, (char**)&fen, 10);
+
+		while (*fen == ' ')
+			fen++;
+
+		if (*fen >= '1' && *fen <= '9')
+			data->fullmove_number = (int)std::strtol(fen, (char**)&fen, 10);
+	}
+
+	ChessRules::findAttackedPoses(data);
+
+	// The side that just moved cannot have left its king in check, the
+	// search would capture it.
+	if (ChessRules::isAttacked(data, data->board.findKing(!turn), turn))
+		return false;
+
+	data->prev_move.check = ChessRules::isAttacked(data, data->board.findKing(turn), !turn);
+
+	data->board.hashCastling(15 ^ data->castling.getRights());
+	data->board.hashEnPassant(en_passant_file(data->prev_move));
+	if (!turn)
+		data->board.hashSide();
+
+	return true;
+}
+
+std::string ChessRules::getFen(ChessGameData* data)
+{
+	const char* symbols = "KQRBNPkqrbnp";
+
+	std::string fen;
+
+	for (int y = 7; y >= 0; y--)
+	{
+		int empty = 0;
+
+		for (uint8_t x = 0; x < 8; x++)
+		{
+			Figure figure;
+			if (!data->board.getFigure(pos_t(x, y), figure))
+			{
+				empty++;
+				continue;
+			}
+
+			if (empty > 0)
+				fen += (char)('0' + empty);
+			empty = 0;
+
+			fen += symbols[figure];
+		}
+
+		if (empty > 0)
+			fen += (char)('0' + empty);
+		if (y > 0)
+			fen += '/';
+	}
+
+	bool turn = !color(data->prev_move.figure);
+	fen += turn ? " w " : " b ";
+
+	uint8_t rights = data->castling.getRights();
+	for (uint8_t i = 0; i < 4; i++)
+	{
+		if (rights & (1 << i))
+			fen += "KQkq"[i];
+	}
+	if (rights == 0)
+		fen += '-';
+
+	uint8_t file = en_passant_file(data->prev_move);
+	if (file < 8)
+	{
+		fen += ' ';
+		fen += (char)('a' + file);
+		fen += turn ? '6' : '3';
+	}
+	else
+		fen += " -";
+
+	fen += ' ' + std::to_string(data->halfmove_clock) + ' ' + std::to_string(data->fullmove_number);
+
+	return fen;
+}
\ No newline at end of file
@@ -0,0 +1,232 @@
+#pragma once
+
+#include "Board.h"
+#include <string>
+#include <vector>
+
+struct Move
+{
+	Move();
+	Move(Figure figure, pos_t from, pos_t to);
+
+	Figure figure;
+	pos_t from;
+	pos_t to;
+
+	Figure promoted;
+
+	bool capture = false;
+	bool en_passant = false;
+	bool promotion = false;
+	bool short_castling = false;
+	bool long_castling = false;
+
+	bool check = false;
+	bool checkmate = false;
+	bool draw = false;
+
+	friend bool operator== (Move move1, Move move2);
+};
+
+// Packed move used by generation and search: from | to << 6 | flags << 12.
+// The annotated Move above is kept for notation and the front ends.
+typedef uint16_t move16_t;
+
+enum MoveFlag : uint8_t
+{
+	FLAG_QUIET = 0,
+	FLAG_DOUBLE_PUSH = 1,
+	FLAG_SHORT_CASTLING = 2,
+	FLAG_LONG_CASTLING = 3,
+	FLAG_CAPTURE = 4,
+	FLAG_EN_PASSANT = 5,
+
+	// Promotion flags carry the piece in their low bits, queen to knight.
+	FLAG_PROMOTION = 8,
+	FLAG_CAPTURE_PROMOTION = 12
+};
+
+const move16_t NO_MOVE = 0;
+
+inline move16_t make_move16(uint8_t from, uint8_t to, uint8_t flags)
+{
+	return (move16_t)(from | (to << 6) | (flags << 12));
+}
+
+inline uint8_t move_from(move16_t move)
+{
+	return move & 63;
+}
+
+inline uint8_t move_to(move16_t move)
+{
+	return (move >> 6) & 63;
+}
+
+inline uint8_t move_flags(move16_t move)
+{
+	return move >> 12;
+}
+
+inline bool is_capture(move16_t move)
+{
+	return (move_flags(move) & FLAG_CAPTURE) != 0;
+}
+
+inline bool is_promotion(move16_t move)
+{
+	return (move_flags(move) & FLAG_PROMOTION) != 0;
+}
+
+// Fixed capacity, enough for any legal position, so that generation never
+// touches the heap.
+struct MoveList
+{
+	move16_t moves[256];
+	int size = 0;
+
+	void add(move16_t move) { this->moves[this->size++] = move; }
+
+	move16_t* begin() { return this->moves; }
+	move16_t* end() { return this->moves + this->size; }
+};
+
+struct EvalMove
+{
+	float score;
+	move16_t move = NO_MOVE;
+};
+
+struct CastlingData
+{
+	bool white_castling_done = false;
+	bool black_castling_done = false;
+
+	bool wk_moved = false;
+	bool white_rook_moved[2] = { false, false };
+
+	bool bk_moved = false;
+	bool black_rook_moved[2] = { false, false };
+
+	void updateData(Move& move);
+	uint8_t getRights();
+};
+
+struct ChessGameData
+{
+	Board board;
+
+	// Annotated moves made through the Move overloads, for display. Search
+	// makes packed moves, which only update ply.
+	std::vector<Move> moves;
+	int ply = 0;
+	Move prev_move = Move(wK, pos_t(0, 0), pos_t(0, 0));
+
+	CastlingData castling;
+
+	bitboard_t white_attacks = 0;
+	bitboard_t black_attacks = 0;
+
+	// Pieces giving check to the side to move and its pieces pinned to the king.
+	bitboard_t checkers = 0;
+	bitboard_t pinned = 0;
+
+	int halfmove_clock = 0;
+	int fullmove_number = 1;
+};
+
+struct UndoData
+{
+	Move prev_move = Move(wK, pos_t(0, 0), pos_t(0, 0));
+	CastlingData castling;
+
+	bool capture = false;
+	Figure captured = wK;
+
+	bitboard_t white_attacks;
+	bitboard_t black_attacks;
+
+	bitboard_t checkers;
+	bitboard_t pinned;
+
+	int halfmove_clock;
+
+	// A king move invalidates its side's half of the network accumulator.
+	// Given a slot, as the search gives one per ply, that half is saved in
+	// it and put back by unmakeMove instead of being recomputed.
+	NnueHalfAccumulator* accumulator = nullptr;
+	bool accumulator_saved = false;
+};
+
+const char* const START_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+enum Ending : uint8_t
+{
+	WHITE_WIN,
+	BLACK_WIN,
+	STALEMATE,
+	IMPOSSIBILITY
+};
+
+std::string to_string(Ending ending);
+std::string to_string(Move move);
+std::string to_uci(Move move);
+std::string to_uci(move16_t move);
+
+move16_t pack_move(Move move);
+
+// Move generation, legality and evaluation. Has no dependency on SFML so
+// that it can be driven by the GUI as well as by headless front ends.
+class ChessRules
+{
+public:
+	static void makeMove(ChessGameData* data, Move& move, UndoData& undo);
+	static void unmakeMove(ChessGameData* data, Move& move, UndoData& undo);
+
+	// Packed moves must be legal in the position. They are played on the
+	// board directly; prev_move is rebuilt without the check annotation of
+	// unpackMove, except for check itself, which the new pins give for free.
+	static void makeMove(ChessGameData* data, move16_t move, UndoData& undo);
+	static void unmakeMove(ChessGameData* data, move16_t move, UndoData& undo);
+	static Move unpackMove(ChessGameData* data, move16_t move);
+
+	// Passes the turn, recorded as a king move to its own square, the same
+	// as loadFen does. Must not be used while in check.
+	static void makeNullMove(ChessGameData* data, UndoData& undo);
+	static void unmakeNullMove(ChessGameData* data, UndoData& undo);
+
+	static float calcScore(ChessGameData* data, bool active, Ending ending);
+
+	static bool checkMove(ChessGameData* data, Move& move);
+	static bool checkCheck(ChessGameData* data, bool& wk_check, bool& bk_check);
+	static bool isAvailable(ChessGameData* data, Move& move);
+
+	// Both take a move that passed checkMove. isLegal only looks at the check
+	// and pin masks found by findPins, so it does not play the move.
+	static bool isLegal(ChessGameData* data, Move& move);
+	static bool givesCheck(ChessGameData* data, Move& move);
+
+	// Whether a move from an untrusted source, such as the transposition
+	// table or the killer slots, is legal for the side to move.
+	static bool isValid(ChessGameData* data, move16_t move);
+
+	// All legal moves of the side to move with a target in mask, in the order
+	// of findPossibleMoves over the squares of the side.
+	static void generateMoves(ChessGameData* data, MoveList& list, bitboard_t mask = ~0ULL);
+
+	static std::vector<Move> findPossibleMoves(ChessGameData* data, pos_t pos, bitboard_t mask = ~0ULL);
+	static void findAttackedPoses(ChessGameData* data);
+	static void findPins(ChessGameData* data);
+	static bool isAttacked(ChessGameData* data, pos_t pos, bool color);
+
+	static bool checkImpossibility(ChessGameData* data);
+	static bool checkEnding(ChessGameData* data, Ending& ending);
+
+	static bool parseMove(ChessGameData* data, std::string str, bool turn, Move& move);
+
+	// loadFen does not allocate, so it can be used to stream large EPD files.
+	// Positions that cannot arise in a game, with pawns on the first or last
+	// rank or the side not to move in check, are rejected.
+	static bool loadFen(ChessGameData* data, const char* fen, bool& turn);
+	static std::string getFen(ChessGameData* data);
+};
@@ -0,0 +1,265 @@
+#include "Match.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <mutex>
+#include <thread>
+
+const char* const match_openings[] =
+{
+	"r1bqkbnr/1ppp1ppp/p1n5/1B2p3/4P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 0 4",
+	"r1bqk1nr/pppp1ppp/2n5/2b1p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4",
+	"rnbqkb1r/pppp1ppp/5n2/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3",
+	"rnbqkb1r/pppp1ppp/5n2/4p3/4P3/2N5/PPPP1PPP/R1BQKBNR w KQkq - 2 3",
+	"rnbqkb1r/pp2pppp/3p1n2/8/3NP3/8/PPP2PPP/RNBQKB1R w KQkq - 1 5",
+	"r1bqkbnr/pp1ppppp/2n5/8/3NP3/8/PPP2PPP/RNBQKB1R b KQkq - 0 4",
+	"r1bqkbnr/pp1ppppp/2n5/2p5/4P3/2N3P1/PPPP1P1P/R1BQKBNR b KQkq - 0 3",
+	"rnbqkb1r/pp1ppppp/5n2/2p5/4P3/2P5/PP1P1PPP/RNBQKBNR w KQkq - 1 3",
+	"rnbqkb1r/ppp2ppp/4pn2/3p4/3PP3/2N5/PPP2PPP/R1BQKBNR w KQkq - 2 4",
+	"rnbqkbnr/pp3ppp/4p3/2ppP3/3P4/8/PPP2PPP/RNBQKBNR w KQkq c6 0 4",
+	"rn1qkbnr/pp2pppp/2p5/3pPb2/3P4/8/PPP2PPP/RNBQKBNR w KQkq - 1 4",
+	"rnbqkbnr/pp2pppp/2p5/8/3PN3/8/PPP2PPP/R1BQKBNR b KQkq - 0 4",
+	"rnbqkb1r/ppp1pp1p/3p1np1/8/3PP3/2N5/PPP2PPP/R1BQKBNR w KQkq - 0 4",
+	"rnb1kbnr/ppp1pppp/8/q7/8/2N5/PPPP1PPP/R1BQKBNR w KQkq - 2 4",
+	"rnbqkb1r/ppp2ppp/4pn2/3p4/2PP4/2N5/PP2PPPP/R1BQKBNR w KQkq - 2 4",
+	"rnbqkb1r/pp2pppp/2p2n2/3p4/2PP4/5N2/PP2PPPP/RNBQKB1R w KQkq - 2 4",
+	"rnbqkb1r/ppp1pppp/5n2/8/2pP4/5N2/PP2PPPP/RNBQKB1R w KQkq - 2 4",
+	"rnbqk2r/pppp1ppp/4pn2/8/1bPP4/2N5/PP2PPPP/R1BQKBNR w KQkq - 2 4",
+	"rnbqk2r/ppp1ppbp/3p1np1/8/2PPP3/2N5/PP3PPP/R1BQKBNR w KQkq - 0 5",
+	"rnbqkb1r/p1pp1ppp/1p2pn2/8/2PP4/5N2/PP2PPPP/RNBQKB1R w KQkq - 0 4",
+	"rnbqkb1r/pp1p1ppp/4pn2/2pP4/2P5/8/PP2PPPP/RNBQKBNR w KQkq - 0 4",
+	"rnbqkb1r/pppp2pp/4pn2/5p2/3P4/6P1/PPP1PPBP/RNBQK1NR w KQkq - 0 4",
+	"r1bqkb1r/pppp1ppp/2n2n2/4p3/2P5/2N2N2/PP1PPPPP/R1BQKB1R w KQkq - 4 4",
+	"r1bqkb1r/pp1ppppp/2n2n2/2p5/2P5/2N2N2/PP1PPPPP/R1BQKB1R w KQkq - 4 4",
+	"rnbqkb1r/ppp2ppp/4pn2/3p4/8/5NP1/PPPPPPBP/RNBQK2R w KQkq - 0 4",
+	"rnbqk2r/ppppppbp/5np1/8/2P5/1P3N2/P2PPPPP/RNBQKB1R w KQkq - 1 4",
+	"rnbqkb1r/ppp2ppp/4pn2/3p4/3P1B2/5N2/PPP1PPPP/RN1QKB1R w KQkq - 0 4",
+	"rnbqk1nr/ppp1ppbp/3p2p1/8/3PP3/2N5/PPP2PPP/R1BQKBNR w KQkq - 0 4"
+};
+
+const int match_openings_size = sizeof(match_openings) / sizeof(match_openings[0]);
+
+// Whether the position occurred twice before since the last capture or
+// pawn move, with the same side to move.
+bool is_repetition(const std::vector<uint64_t>& keys, int halfmove_clock)
+{
+	int count = 0;
+	int last = (int)keys.size() - 1;
+
+	for (int i = last - 2; i >= 0 && i >= last - halfmove_clock; i -= 2)
+	{
+		if (keys[i] == keys[last] && ++count == 2)
+			return true;
+	}
+
+	return false;
+}
+
+int play_game(const MatchOptions& options, const std::string& opening, const EngineConfig* engines[2], TranspositionTable* tables[2])
+{
+	ChessGameData data;
+	bool turn;
+	if (!ChessRules::loadFen(&data, opening.c_str(), turn))
+		return 0;
+
+	tables[0]->clear();
+	tables[1]->clear();
+
+	std::vector<uint64_t> keys(1, data.board.getKey());
+
+	int draw_count = 0;
+	int resign_count = 0;
+
+	for (int ply = 0; ply < options.max_plies; ply++)
+	{
+		Ending ending;
+		if (ChessRules::checkEnding(&data, ending))
+			return ending == WHITE_WIN ? 1 : ending == BLACK_WIN ? -1 : 0;
+
+		if (data.halfmove_clock >= 100 || is_repetition(keys, data.halfmove_clock))
+			return 0;
+
+		SearchInfo info;
+		info.tt = tables[!turn];
+
+		EvalMove best = Search::iterativeDeepening(&data, turn, engines[!turn]->limits, &info);
+
+		// White positive centipawns, the same for both engines.
+		int score = (int)std::round(best.score / 11.2f * 100.0f);
+
+		if (data.fullmove_number >= options.draw_move_number && std::abs(score) <= options.draw_score)
+			draw_count++;
+		else
+			draw_count = 0;
+
+		// Counts up for white and down for black, restarting on a change of side.
+		if (std::abs(score) < options.resign_score)
+			resign_count = 0;
+		else if (resign_count == 0 || (resign_count > 0) != (score > 0))
+			resign_count = score > 0 ? 1 : -1;
+		else
+			resign_count += score > 0 ? 1 : -1;
+
+		if (draw_count >= options.draw_plies)
+			return 0;
+
+		if (std::abs(resign_count) >= options.resign_plies)
+			return resign_count > 0 ? 1 : -1;
+
+		UndoData undo;
+		ChessRules::makeMove(&data, best.move, undo);
+		turn = !turn;
+
+		keys.push_back(data.board.getKey());
+	}
+
+	return 0;
+}
+
+MatchResult play_match(const MatchOptions& options, std::function<void(const MatchResult& result)> report)
+{
+	std::vector<std::string> openings;
+
+	// A position that does not load would otherwise be scored as a draw.
+	for (const std::string& opening : options.openings)
+	{
+		ChessGameData data;
+		bool turn;
+		if (ChessRules::loadFen(&data, opening.c_str(), turn))
+			openings.push_back(opening);
+	}
+
+	if (options.openings.empty())
+		openings.assign(match_openings, match_openings + match_openings_size);
+
+	MatchResult result;
+
+	if (openings.empty())
+		return result;
+
+	std::mutex mutex;
+
+	std::atomic<int> next{ 0 };
+	std::atomic<bool> stop{ false };
+
+	float lower, upper;
+	sprt_bounds(options.alpha, options.beta, lower, upper);
+
+	auto worker = [&]()
+	{
+		TranspositionTable first(options.engines[0].hash), second(options.engines[1].hash);
+
+		while (!stop)
+		{
+			int game = next++;
+			if (game >= options.games)
+				break;
+
+			// Both games of a pair use the same opening, the first engine
+			// playing white in the even one.
+			bool swap = game % 2 != 0;
+
+			const EngineConfig* engines[2] = { &options.engines[swap], &options.engines[!swap] };
+			TranspositionTable* tables[2] = { swap ? &second : &first, swap ? &first : &second };
+
+			int outcome = play_game(options, openings[game / 2 % openings.size()], engines, tables);
+			if (swap)
+				outcome = -outcome;
+
+			std::lock_guard<std::mutex> lock(mutex);
+
+			if (outcome > 0)
+				result.wins++;
+			else if (outcome < 0)
+				result.losses++;
+			else
+				result.draws++;
+
+			report(result);
+
+			if (options.sprt)
+			{
+				float llr = sprt_llr(result, options.elo0, options.elo1);
+				if (llr <= lower || llr >= upper)
+					stop = true;
+			}
+		}
+	};
+
+	std::vector<std::thread> threads;
+	for (int i = 1; i < options.concurrency; i++)
+		threads.push_back(std::thread(worker));
+
+	worker();
+
+	for (std::thread& thread : threads)
+		thread.join();
+
+	return result;
+}
+
+//------------------------------------------------------------------------------------
+
+float expected_score(float elo)
+{
+	return 1.0f / (1.0f + std::pow(10.0f, -elo / 400.0f));
+}
+
+float score_elo(float score)
+{
+	score = std::min(std::max(score, 0.001f), 0.999f);
+	return -400.0f * std::log10(1.0f / score - 1.0f);
+}
+
+// Mean and variance of the score of one game.
+void score_stats(const MatchResult& result, float& mean, float& variance)
+{
+	float n = (float)result.games();
+
+	mean = (result.wins + result.draws * 0.5f) / n;
+	variance = (result.wins * (1.0f - mean) * (1.0f - mean) +
+		result.draws * (0.5f - mean) * (0.5f - mean) +
+		result.losses * mean * mean) / n;
+}
+
+float elo_difference(const MatchResult& result, float& error)
+{
+	if (result.games() == 0)
+	{
+		error = 0.0f;
+		return 0.0f;
+	}
+
+	float mean, variance;
+	score_stats(result, mean, variance);
+
+	float margin = 1.96f * std::sqrt(variance / result.games());
+	error = (score_elo(mean + margin) - score_elo(mean - margin)) / 2.0f;
+
+	return score_elo(mean);
+}
+
+// Normal approximation of the trinomial GSPRT, as used by fishtest.
+float sprt_llr(const MatchResult& result, float elo0, float elo1)
+{
+	if (result.games() == 0)
+		return 0.0f;
+
+	float mean, variance;
+	score_stats(result, mean, variance);
+
+	// Until the results differ there is nothing to tell the hypotheses apart.
+	if (variance == 0.0f)
+		return 0.0f;
+
+	float s0 = expected_score(elo0);
+	float s1 = expected_score(elo1);
+
+	return result.games() * (s1 - s0) * (2.0f * mean - s0 - s1) / (2.0f * variance);
+}
+
+void sprt_bounds(float alpha, float beta, float& lower, float& upper)
+{
+	lower = std::log(beta / (1.0f - alpha));
+	upper = std::log((1.0f - beta) / alpha);
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "Search.h"
+#include <functional>
+#include <string>
+
+struct EngineConfig
+{
+	SearchLimits limits;
+	size_t hash = 16;
+};
+
+// Two engine configurations play games in pairs from each opening, with
+// colors swapped, on concurrency threads. Each engine has a transposition
+// table of its own, cleared before every game. A game is adjudicated by
+// checkEnding, threefold repetition and the fifty-move rule, then:
+//   draw when both engines scored within draw_score centipawns of zero for
+//   draw_plies plies in a row after draw_move_number moves;
+//   a win when both agreed on a side leading by resign_score for
+//   resign_plies plies in a row;
+//   a draw at max_plies.
+struct MatchOptions
+{
+	EngineConfig engines[2];
+
+	int games = 1000;
+	int concurrency = 1;
+
+	// FENs or EPDs, of which those that do not load are skipped; the
+	// built-in suite when empty.
+	std::vector<std::string> openings;
+
+	int draw_move_number = 40;
+	int draw_plies = 8;
+	int draw_score = 10;
+
+	int resign_plies = 6;
+	int resign_score = 1000;
+
+	int max_plies = 600;
+
+	// The match stops early once the SPRT of elo0 against elo1 accepts
+	// either hypothesis, unless sprt is cleared.
+	bool sprt = true;
+	float elo0 = 0.0f;
+	float elo1 = 5.0f;
+	float alpha = 0.05f;
+	float beta = 0.05f;
+};
+
+// Counted for the first engine.
+struct MatchResult
+{
+	int wins = 0;
+	int draws = 0;
+	int losses = 0;
+
+	int games() const { return wins + draws + losses; }
+};
+
+extern const char* const match_openings[];
+extern const int match_openings_size;
+
+// Result of one game for the engine playing white: 1, 0 or -1. The
+// opening must load.
+int play_game(const MatchOptions& options, const std::string& opening, const EngineConfig* engines[2], TranspositionTable* tables[2]);
+
+// Calls report after every game, serialized, and returns the final counts.
+MatchResult play_match(const MatchOptions& options, std::function<void(const MatchResult& result)> report);
+
+// Elo difference of the first engine, and the half-width of its 95%
+// confidence interval.
+float elo_difference(const MatchResult& result, float& error);
+
+// Log-likelihood ratio of elo1 against elo0, and the bounds that accept
+// elo0 (lower) or elo1 (upper).
+float sprt_llr(const MatchResult& result, float elo0, float elo1);
+void sprt_bounds(float alpha, float beta, float& lower, float& upper);
@@ -0,0 +1,170 @@
+#include "MovePicker.h"
+
+MovePicker::MovePicker(ChessGameData* data, SearchInfo* info, bool turn, bool tactical_only, move16_t hash_move)
+{
+	this->data = data;
+	this->info = info;
+	this->turn = turn;
+	this->tactical_only = tactical_only;
+
+	this->stage = HASH_MOVE;
+
+	this->hash_move = hash_move;
+
+	this->killer_index = 0;
+	this->killer_count = 0;
+
+	this->current = 0;
+}
+
+bool MovePicker::next(move16_t& move)
+{
+	switch (this->stage)
+	{
+	case HASH_MOVE:
+		this->stage = CAPTURES_INIT;
+
+		if (this->hash_move != NO_MOVE)
+		{
+			if (ChessRules::isValid(this->data, this->hash_move))
+			{
+				move = this->hash_move;
+				return true;
+			}
+
+			this->hash_move = NO_MOVE;
+		}
+		// fall through
+
+	case CAPTURES_INIT:
+	{
+		Move& prev = this->data->prev_move;
+
+		bitboard_t mask = this->data->board.getOccupancy(!this->turn) | (this->turn ? RANK_8 : RANK_1);
+		if ((prev.figure == wP || prev.figure == bP) && std::abs(prev.to.y - prev.from.y) == 2)
+			mask |= square_bb(to_square(pos_t(prev.to.x, (prev.from.y + prev.to.y) / 2)));
+
+		this->generate(mask, true);
+		this->stage = CAPTURES;
+	}
+		// fall through
+
+	case CAPTURES:
+		if (this->current < this->moves.size)
+		{
+			move = this->moves.moves[this->current++];
+			return true;
+		}
+
+		if (this->tactical_only)
+		{
+			this->stage = DONE;
+			return false;
+		}
+
+		this->stage = KILLERS;
+		// fall through
+
+	case KILLERS:
+		while (this->killer_index < 2 && this->info->ply < MAX_PLY)
+		{
+			move16_t killer = this->info->killers[this->info->ply][this->killer_index++];
+
+			if (killer == this->hash_move || is_capture(killer) || is_promotion(killer) || !ChessRules::isValid(this->data, killer))
+				continue;
+
+			this->killers[this->killer_count++] = killer;
+
+			move = killer;
+			return true;
+		}
+
+		this->stage = QUIETS_INIT;
+		// fall through
+
+	case QUIETS_INIT:
+		this->generate(~this->data->board.getOccupancy(!this->turn), false);
+		this->stage = QUIETS;
+		// fall through
+
+	case QUIETS:
+		if (this->current < this->moves.size)
+		{
+			move = this->moves.moves[this->current++];
+			return true;
+		}
+
+		this->stage = DONE;
+		// fall through
+
+	default:
+		return false;
+	}
+}
+
+bool MovePicker::isSkipped(move16_t move)
+{
+	if (move == this->hash_move)
+		return true;
+
+	for (uint8_t i = 0; i < this->killer_count; i++)
+	{
+		if (move == this->killers[i])
+			return true;
+	}
+
+	return false;
+}
+
+void MovePicker::generate(bitboard_t mask, bool tactical)
+{
+	MoveList list;
+
+	if (this->info->stats.timing)
+	{
+		auto start = std::chrono::steady_clock::now();
+		ChessRules::generateMoves(this->data, list, mask);
+		this->info->stats.movegen_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+	}
+	else
+		ChessRules::generateMoves(this->data, list, mask);
+
+	this->moves.size = 0;
+	this->current = 0;
+
+	for (move16_t move : list)
+	{
+		if ((is_capture(move) || is_promotion(move)) != tactical || this->isSkipped(move))
+			continue;
+
+		Figure figure;
+		this->data->board.getFigure(to_pos(move_from(move)), figure);
+
+		int score;
+
+		if (tactical)
+		{
+			Figure victim = figure;
+			if (move_flags(move) == FLAG_EN_PASSANT || this->data->board.getFigure(to_pos(move_to(move)), victim))
+				score = fscore(victim) * 256 - fscore(figure);
+			else
+				score = -fscore(figure);
+
+			if (is_promotion(move))
+				score += (fscore((Figure)(wQ + (move_flags(move) & 3))) - 1) * 256;
+		}
+		else
+			score = this->info->history[figure][move_to(move)];
+
+		// Insertion sort keeps equal scores in generation order.
+		int i = this->moves.size++;
+		for (; i > 0 && this->scores[i - 1] < score; i--)
+		{
+			this->moves.moves[i] = this->moves.moves[i - 1];
+			this->scores[i] = this->scores[i - 1];
+		}
+
+		this->moves.moves[i] = move;
+		this->scores[i] = score;
+	}
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Search.h"
+
+// Yields the moves of a position in stages: hash move, captures and
+// promotions by MVV-LVA, killers, then quiet moves by history score.
+// Each stage is generated only when the previous ones did not cut off.
+class MovePicker
+{
+public:
+	MovePicker(ChessGameData* data, SearchInfo* info, bool turn, bool tactical_only, move16_t hash_move);
+
+	bool next(move16_t& move);
+
+private:
+	enum Stage : uint8_t
+	{
+		HASH_MOVE,
+		CAPTURES_INIT,
+		CAPTURES,
+		KILLERS,
+		QUIETS_INIT,
+		QUIETS,
+		DONE
+	};
+
+	ChessGameData* data;
+	SearchInfo* info;
+	bool turn;
+	bool tactical_only;
+
+	Stage stage;
+
+	move16_t hash_move;
+
+	move16_t killers[2];
+	uint8_t killer_index;
+	uint8_t killer_count;
+
+	MoveList moves;
+	int scores[256];
+	int current;
+
+	bool isSkipped(move16_t move);
+
+	void generate(bitboard_t mask, bool tactical);
+};
@@ -0,0 +1,232 @@
+#include "Nnue.h"
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <vector>
+
+#if defined(USE_AVX2)
+#include <immintrin.h>
+#elif defined(USE_SSE41)
+#include <smmintrin.h>
+#endif
+
+const uint32_t NNUE_MAGIC = 0x45554E4E;
+const uint32_t NNUE_VERSION = 1;
+
+// Hidden layer sums are scaled down by 2^6 before clipping, and the output
+// by 16 to give centipawns.
+const int WEIGHT_SCALE_BITS = 6;
+const int OUTPUT_SCALE = 16;
+
+struct Network
+{
+	std::vector<int16_t> transformer_biases;
+	std::vector<int16_t> transformer_weights;
+
+	int32_t hidden1_biases[NNUE_HIDDEN];
+	int8_t hidden1_weights[NNUE_HIDDEN][2 * NNUE_HALF_DIMENSIONS];
+
+	int32_t hidden2_biases[NNUE_HIDDEN];
+	int8_t hidden2_weights[NNUE_HIDDEN][NNUE_HIDDEN];
+
+	int32_t output_bias;
+	int8_t output_weights[NNUE_HIDDEN];
+};
+
+Network network;
+bool nnue_loaded = false;
+
+template <typename T>
+bool read(std::ifstream& file, T* data, size_t count)
+{
+	file.read((char*)data, sizeof(T) * count);
+	return (size_t)file.gcount() == sizeof(T) * count;
+}
+
+bool nnue_load(const char* path)
+{
+	std::ifstream file(path, std::ios::binary);
+
+	uint32_t header[2];
+	if (!file || !read(file, header, 2) || header[0] != NNUE_MAGIC || header[1] != NNUE_VERSION)
+		return false;
+
+	// Read aside, so that a truncated file leaves the loaded network intact.
+	std::unique_ptr<Network> loaded(new Network());
+
+	loaded->transformer_biases.resize(NNUE_HALF_DIMENSIONS);
+	loaded->transformer_weights.resize((size_t)NNUE_FEATURES * NNUE_HALF_DIMENSIONS);
+
+	bool ok = read(file, loaded->transformer_biases.data(), loaded->transformer_biases.size()) &&
+		read(file, loaded->transformer_weights.data(), loaded->transformer_weights.size()) &&
+		read(file, loaded->hidden1_biases, NNUE_HIDDEN) &&
+		read(file, &loaded->hidden1_weights[0][0], NNUE_HIDDEN * 2 * NNUE_HALF_DIMENSIONS) &&
+		read(file, loaded->hidden2_biases, NNUE_HIDDEN) &&
+		read(file, &loaded->hidden2_weights[0][0], NNUE_HIDDEN * NNUE_HIDDEN) &&
+		read(file, &loaded->output_bias, 1) &&
+		read(file, loaded->output_weights, NNUE_HIDDEN);
+
+	if (!ok)
+		return false;
+
+	network = std::move(*loaded);
+	nnue_loaded = true;
+	return true;
+}
+
+int nnue_feature(bool perspective, uint8_t king, uint8_t figure, uint8_t square)
+{
+	// Black sees the board flipped, so that both perspectives share weights.
+	if (!perspective)
+	{
+		king ^= 56;
+		square ^= 56;
+	}
+
+	bool own = (figure < 6) == perspective;
+	int piece = (figure % 6 - 1) * 2 + !own;
+
+	return (king * 10 + piece) * 64 + square;
+}
+
+//------------------------------------------------------------------------------------
+
+void nnue_add_feature(NnueAccumulator& accumulator, bool perspective, int feature)
+{
+	int16_t* values = accumulator.values[!perspective];
+	const int16_t* row = &network.transformer_weights[(size_t)feature * NNUE_HALF_DIMENSIONS];
+
+#if defined(USE_AVX2)
+	for (int i = 0; i < NNUE_HALF_DIMENSIONS; i += 16)
+	{
+		__m256i sum = _mm256_add_epi16(_mm256_loadu_si256((const __m256i*)(values + i)), _mm256_loadu_si256((const __m256i*)(row + i)));
+		_mm256_storeu_si256((__m256i*)(values + i), sum);
+	}
+#elif defined(USE_SSE41)
+	for (int i = 0; i < NNUE_HALF_DIMENSIONS; i += 8)
+	{
+		__m128i sum = _mm_add_epi16(_mm_loadu_si128((const __m128i*)(values + i)), _mm_loadu_si128((const __m128i*)(row + i)));
+		_mm_storeu_si128((__m128i*)(values + i), sum);
+	}
+#else
+	for (int i = 0; i < NNUE_HALF_DIMENSIONS; i++)
+		values[i] += row[i];
+#endif
+}
+
+void nnue_sub_feature(NnueAccumulator& accumulator, bool perspective, int feature)
+{
+	int16_t* values = accumulator.values[!perspective];
+	const int16_t* row = &network.transformer_weights[(size_t)feature * NNUE_HALF_DIMENSIONS];
+
+#if defined(USE_AVX2)
+	for (int i = 0; i < NNUE_HALF_DIMENSIONS; i += 16)
+	{
+		__m256i difference = _mm256_sub_epi16(_mm256_loadu_si256((const __m256i*)(values + i)), _mm256_loadu_si256((const __m256i*)(row + i)));
+		_mm256_storeu_si256((__m256i*)(values + i), difference);
+	}
+#elif defined(USE_SSE41)
+	for (int i = 0; i < NNUE_HALF_DIMENSIONS; i += 8)
+	{
+		__m128i difference = _mm_sub_epi16(_mm_loadu_si128((const __m128i*)(values + i)), _mm_loadu_si128((const __m128i*)(row + i)));
+		_mm_storeu_si128((__m128i*)(values + i), difference);
+	}
+#else
+	for (int i = 0; i < NNUE_HALF_DIMENSIONS; i++)
+		values[i] -= row[i];
+#endif
+}
+
+void nnue_reset(NnueAccumulator& accumulator, bool perspective)
+{
+	std::copy(network.transformer_biases.begin(), network.transformer_biases.end(), accumulator.values[!perspective]);
+}
+
+//------------------------------------------------------------------------------------
+
+// Clips the transformer output to 0..127.
+void clip_transformed(const int16_t* values, uint8_t* output)
+{
+#if defined(USE_AVX2)
+	const __m256i zero = _mm256_setzero_si256();
+
+	for (int i = 0; i < NNUE_HALF_DIMENSIONS; i += 32)
+	{
+		__m256i packed = _mm256_packs_epi16(_mm256_loadu_si256((const __m256i*)(values + i)), _mm256_loadu_si256((const __m256i*)(values + i + 16)));
+		packed = _mm256_permute4x64_epi64(_mm256_max_epi8(packed, zero), 0xD8);
+		_mm256_storeu_si256((__m256i*)(output + i), packed);
+	}
+#elif defined(USE_SSE41)
+	const __m128i zero = _mm_setzero_si128();
+
+	for (int i = 0; i < NNUE_HALF_DIMENSIONS; i += 16)
+	{
+		__m128i packed = _mm_packs_epi16(_mm_loadu_si128((const __m128i*)(values + i)), _mm_loadu_si128((const __m128i*)(values + i + 8)));
+		_mm_storeu_si128((__m128i*)(output + i), _mm_max_epi8(packed, zero));
+	}
+#else
+	for (int i = 0; i < NNUE_HALF_DIMENSIONS; i++)
+		output[i] = (uint8_t)std::min(std::max((int)values[i], 0), 127);
+#endif
+}
+
+// Inputs are at most 127, so the pairwise int16 sums cannot saturate.
+int32_t dot(const uint8_t* input, const int8_t* weights, int size)
+{
+#if defined(USE_AVX2)
+	const __m256i ones = _mm256_set1_epi16(1);
+	__m256i sum = _mm256_setzero_si256();
+
+	for (int i = 0; i < size; i += 32)
+	{
+		__m256i products = _mm256_maddubs_epi16(_mm256_loadu_si256((const __m256i*)(input + i)), _mm256_loadu_si256((const __m256i*)(weights + i)));
+		sum = _mm256_add_epi32(sum, _mm256_madd_epi16(products, ones));
+	}
+
+	__m128i total = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+	total = _mm_add_epi32(total, _mm_shuffle_epi32(total, 0x4E));
+	total = _mm_add_epi32(total, _mm_shuffle_epi32(total, 0xB1));
+	return _mm_cvtsi128_si32(total);
+#elif defined(USE_SSE41)
+	const __m128i ones = _mm_set1_epi16(1);
+	__m128i sum = _mm_setzero_si128();
+
+	for (int i = 0; i < size; i += 16)
+	{
+		__m128i products = _mm_maddubs_epi16(_mm_loadu_si128((const __m128i*)(input + i)), _mm_loadu_si128((const __m128i*)(weights + i)));
+		sum = _mm_add_epi32(sum, _mm_madd_epi16(products, ones));
+	}
+
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+	return _mm_cvtsi128_si32(sum);
+#else
+	int32_t sum = 0;
+	for (int i = 0; i < size; i++)
+		sum += input[i] * weights[i];
+	return sum;
+#endif
+}
+
+uint8_t clip_hidden(int32_t sum)
+{
+	return (uint8_t)std::min(std::max(sum >> WEIGHT_SCALE_BITS, 0), 127);
+}
+
+int nnue_evaluate(NnueAccumulator& accumulator, bool turn)
+{
+	uint8_t transformed[2 * NNUE_HALF_DIMENSIONS];
+	uint8_t hidden1[NNUE_HIDDEN];
+	uint8_t hidden2[NNUE_HIDDEN];
+
+	clip_transformed(accumulator.values[!turn], transformed);
+	clip_transformed(accumulator.values[turn], transformed + NNUE_HALF_DIMENSIONS);
+
+	for (int i = 0; i < NNUE_HIDDEN; i++)
+		hidden1[i] = clip_hidden(network.hidden1_biases[i] + dot(transformed, network.hidden1_weights[i], 2 * NNUE_HALF_DIMENSIONS));
+
+	for (int i = 0; i < NNUE_HIDDEN; i++)
+		hidden2[i] = clip_hidden(network.hidden2_biases[i] + dot(hidden1, network.hidden2_weights[i], NNUE_HIDDEN));
+
+	return (network.output_bias + dot(hidden2, network.output_weights, NNUE_HIDDEN)) / OUTPUT_SCALE;
+}
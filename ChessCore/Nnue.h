@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+
+// HalfKP network: for each side, the features are (own king square, piece,
+// square) for every piece but the kings, 64 * 10 * 64 of them. They feed a
+// 256 wide int16 transformer whose output, both sides concatenated with the
+// side to move first, goes through int8 layers of 32, 32 and 1 neurons.
+const int NNUE_FEATURES = 64 * 10 * 64;
+const int NNUE_HALF_DIMENSIONS = 256;
+const int NNUE_HIDDEN = 32;
+
+// First layer output of both perspectives, white then black. Board keeps
+// it up to date piece by piece; a king move invalidates its perspective,
+// which is refreshed from scratch when the position is evaluated, unless
+// unmakeMove can put back the half from before the move.
+struct NnueAccumulator
+{
+	int16_t values[2][NNUE_HALF_DIMENSIONS];
+	bool computed[2] = { false, false };
+};
+
+// One perspective of an accumulator, saved around a king move.
+struct NnueHalfAccumulator
+{
+	int16_t values[NNUE_HALF_DIMENSIONS];
+	bool computed = false;
+};
+
+// Weights file layout, little endian:
+//   uint32 magic "NNUE", uint32 version 1
+//   int16 transformer biases[256], weights[40960][256]
+//   int32 hidden1 biases[32], int8 weights[32][512]
+//   int32 hidden2 biases[32], int8 weights[32][32]
+//   int32 output bias, int8 weights[32]
+// On failure the network loaded before, if any, stays in use.
+bool nnue_load(const char* path);
+
+extern bool nnue_loaded;
+
+inline bool nnue_enabled()
+{
+	return nnue_loaded;
+}
+
+int nnue_feature(bool perspective, uint8_t king, uint8_t figure, uint8_t square);
+
+void nnue_add_feature(NnueAccumulator& accumulator, bool perspective, int feature);
+void nnue_sub_feature(NnueAccumulator& accumulator, bool perspective, int feature);
+void nnue_reset(NnueAccumulator& accumulator, bool perspective);
+
+// Score in centipawns from the side to move.
+int nnue_evaluate(NnueAccumulator& accumulator, bool turn);
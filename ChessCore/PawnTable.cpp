@@ -0,0 +1,101 @@
+#include "PawnTable.h"
+#include <cstddef>
+
+const size_t PAWN_TABLE_SIZE = 1 << 14;
+
+const float DOUBLED_PENALTY = 1.5f;
+const float ISOLATED_PENALTY = 1.8f;
+const float BACKWARD_PENALTY = 1.0f;
+const float CHAIN_BONUS = 0.6f;
+
+// By rank from the pawn's own side.
+const float PASSED_BONUS[8] = { 0.0f, 1.0f, 1.5f, 2.5f, 4.0f, 6.5f, 10.0f, 0.0f };
+
+bitboard_t adjacent_files(uint8_t file)
+{
+	return ((file > 0 ? FILE_A << (file - 1) : 0) | (file < 7 ? FILE_A << (file + 1) : 0));
+}
+
+// Squares strictly in front of the square from the given side.
+bitboard_t forward_ranks(bool color, uint8_t square)
+{
+	uint8_t rank = square / 8;
+	return color ? (rank < 7 ? ~0ULL << (8 * (rank + 1)) : 0) : (rank > 0 ? ~0ULL >> (8 * (8 - rank)) : 0);
+}
+
+//------------------------------------------------------------------------------------
+
+PawnTable::PawnTable()
+{
+	this->entries.resize(PAWN_TABLE_SIZE);
+}
+
+PawnEntry* PawnTable::probe(Board& board)
+{
+	uint64_t key = board.getPawnKey();
+	PawnEntry& entry = this->entries[key & (PAWN_TABLE_SIZE - 1)];
+
+	if (entry.key != key)
+	{
+		entry.key = key;
+		this->evaluate(board, entry);
+	}
+
+	return &entry;
+}
+
+void PawnTable::evaluate(Board& board, PawnEntry& entry)
+{
+	entry.score = 0.0f;
+
+	for (uint8_t side = 0; side < 2; side++)
+	{
+		bool clr = side == 0;
+		float sign = clr ? 1.0f : -1.0f;
+
+		bitboard_t own = board.getBitboard(clr ? wP : bP);
+		bitboard_t enemy = board.getBitboard(clr ? bP : wP);
+
+		entry.passed[side] = 0;
+
+		bitboard_t pawns = own;
+		while (pawns)
+		{
+			uint8_t square = pop_lsb(pawns);
+			uint8_t file = square % 8;
+			uint8_t rank = clr ? square / 8 : 7 - square / 8;
+
+			bitboard_t file_bb = FILE_A << file;
+			bitboard_t adjacent = adjacent_files(file);
+			bitboard_t ahead = forward_ranks(clr, square);
+
+			float score = 0.0f;
+
+			if (own & file_bb & ahead)
+				score -= DOUBLED_PENALTY;
+
+			if (!(own & adjacent))
+				score -= ISOLATED_PENALTY;
+			else
+			{
+				// Backward: its stop square is covered by an enemy pawn and
+				// no pawn on a neighbouring file is level with it or behind.
+				uint8_t stop = clr ? square + 8 : square - 8;
+
+				if ((pawn_attacks[!clr][stop] & enemy) && !(own & adjacent & ~ahead))
+					score -= BACKWARD_PENALTY;
+			}
+
+			if (pawn_attacks[clr][square] & own)
+				score += CHAIN_BONUS;
+
+			if (!(enemy & (file_bb | adjacent) & ahead))
+			{
+				entry.passed[side] |= square_bb(square);
+				score += PASSED_BONUS[rank];
+			}
+
+			entry.score += sign * score;
+		}
+	}
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "Board.h"
+#include <vector>
+
+struct PawnEntry
+{
+	uint64_t key = 0;
+
+	// Pawn structure score from white's side, and the passed pawns of
+	// white and black.
+	float score = 0.0f;
+	bitboard_t passed[2] = { 0, 0 };
+};
+
+// Caches the evaluation of pawn structures by the pawn-only Zobrist key.
+// It is not shared between threads; each search thread evaluates with its
+// own table.
+class PawnTable
+{
+public:
+	PawnTable();
+
+	PawnEntry* probe(Board& board);
+
+private:
+	std::vector<PawnEntry> entries;
+
+	void evaluate(Board& board, PawnEntry& entry);
+};
@@ -0,0 +1,96 @@
+#include "Perft.h"
+#include <algorithm>
+
+const PerftPosition perft_suite[] =
+{
+	{ "initial", "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", { 20, 400, 8902, 197281, 4865609 } },
+	{ "kiwipete", "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", { 48, 2039, 97862, 4085603 } },
+	{ "endgame", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", { 14, 191, 2812, 43238, 674624 } },
+	{ "promotions", "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", { 6, 264, 9467, 422333 } },
+	{ "talkchess", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", { 44, 1486, 62379, 2103487 } },
+	{ "middlegame", "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", { 46, 2079, 89890, 3894594 } }
+};
+
+const int perft_suite_size = sizeof(perft_suite) / sizeof(perft_suite[0]);
+
+const char* const invalid_fens[] =
+{
+	"4k3/4Q3/8/8/8/8/8/4K3 w - - 0 1",
+	"P3k3/8/8/8/8/8/8/4K3 w - - 0 1",
+	"4k3/8/8/8/8/8/8/p3K3 b - - 0 1"
+};
+
+const int invalid_fens_size = sizeof(invalid_fens) / sizeof(invalid_fens[0]);
+
+uint64_t perft(ChessGameData* data, bool turn, int depth)
+{
+	MoveList list;
+	ChessRules::generateMoves(data, list);
+
+	if (depth <= 1)
+		return list.size;
+
+	uint64_t nodes = 0;
+
+	for (move16_t move : list)
+	{
+		UndoData undo;
+		ChessRules::makeMove(data, move, undo);
+		nodes += perft(data, !turn, depth - 1);
+		ChessRules::unmakeMove(data, move, undo);
+	}
+
+	return nodes;
+}
+
+std::vector<std::pair<move16_t, uint64_t>> perft_divide(ChessGameData* data, bool turn, int depth)
+{
+	std::vector<std::pair<move16_t, uint64_t>> result;
+
+	MoveList list;
+	ChessRules::generateMoves(data, list);
+
+	for (move16_t move : list)
+	{
+		UndoData undo;
+		ChessRules::makeMove(data, move, undo);
+		result.push_back(std::make_pair(move, depth > 1 ? perft(data, !turn, depth - 1) : 1));
+		ChessRules::unmakeMove(data, move, undo);
+	}
+
+	return result;
+}
+
+uint64_t perft_possible_moves(ChessGameData* data, bool turn, int depth)
+{
+	MoveList list;
+	ChessRules::generateMoves(data, list);
+
+	std::vector<move16_t> generated(list.begin(), list.end());
+	std::vector<move16_t> possible;
+
+	bitboard_t pieces = data->board.getOccupancy(turn);
+	while (pieces)
+	{
+		for (Move& move : ChessRules::findPossibleMoves(data, to_pos(pop_lsb(pieces))))
+			possible.push_back(pack_move(move));
+	}
+
+	std::sort(generated.begin(), generated.end());
+	std::sort(possible.begin(), possible.end());
+
+	uint64_t mismatches = generated != possible;
+
+	if (depth <= 1)
+		return mismatches;
+
+	for (move16_t move : list)
+	{
+		UndoData undo;
+		ChessRules::makeMove(data, move, undo);
+		mismatches += perft_possible_moves(data, !turn, depth - 1);
+		ChessRules::unmakeMove(data, move, undo);
+	}
+
+	return mismatches;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "ChessRules.h"
+#include <utility>
+
+struct PerftPosition
+{
+	const char* name;
+	const char* fen;
+
+	// Expected leaf counts by depth, starting at depth 1; 0 ends the list.
+	uint64_t nodes[6];
+};
+
+extern const PerftPosition perft_suite[];
+extern const int perft_suite_size;
+
+// Positions that loadFen must reject.
+extern const char* const invalid_fens[];
+extern const int invalid_fens_size;
+
+uint64_t perft(ChessGameData* data, bool turn, int depth);
+std::vector<std::pair<move16_t, uint64_t>> perft_divide(ChessGameData* data, bool turn, int depth);
+
+// Walks the tree like perft and returns the number of positions where
+// findPossibleMoves, over the squares of the side to move, does not give the
+// moves of generateMoves.
+uint64_t perft_possible_moves(ChessGameData* data, bool turn, int depth);
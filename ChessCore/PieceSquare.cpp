@@ -0,0 +1,60 @@
+#include "PieceSquare.h"
+#include <algorithm>
+#include <cmath>
+
+int16_t piece_square_mg[12][64];
+int16_t piece_square_eg[12][64];
+
+uint8_t phase_weights[12] = { 0, 4, 2, 1, 1, 0, 0, 4, 2, 1, 1, 0 };
+
+void init_piece_square()
+{
+	const int values[6] = { 0, 9 * 1120, 5 * 1120, 3 * 1120, 3 * 1120, 1120 };
+
+	for (uint8_t square = 0; square < 64; square++)
+	{
+		int x = square % 8;
+		int y = square / 8;
+
+		// 0 in the corners up to 6 in the four central squares.
+		int center = std::min(x, 7 - x) + std::min(y, 7 - y);
+
+		int mg[6], eg[6];
+
+		mg[0] = -80 * std::min(y, 3) - (x >= 2 && x <= 5 ? 40 : 0);
+		eg[0] = 50 * center;
+
+		mg[1] = 0;
+		eg[1] = 20 * center;
+
+		mg[2] = y == 6 ? 100 : 0;
+		eg[2] = 0;
+
+		mg[3] = 20 * center;
+		eg[3] = 20 * center;
+
+		mg[4] = 40 * center;
+		eg[4] = 40 * center;
+
+		// Advanced pawns, worth more once the pieces are traded off.
+		mg[5] = (int)std::round(y * y / 17.2f * 100.0f);
+		eg[5] = (int)std::round(y * y / 11.5f * 100.0f);
+
+		for (uint8_t f = 0; f < 6; f++)
+		{
+			piece_square_mg[f][square] = (int16_t)(values[f] + mg[f]);
+			piece_square_eg[f][square] = (int16_t)(values[f] + eg[f]);
+
+			piece_square_mg[f + 6][square ^ 56] = (int16_t)-(values[f] + mg[f]);
+			piece_square_eg[f + 6][square ^ 56] = (int16_t)-(values[f] + eg[f]);
+		}
+	}
+}
+
+struct PieceSquareInit
+{
+	PieceSquareInit()
+	{
+		init_piece_square();
+	}
+} piece_square_init;
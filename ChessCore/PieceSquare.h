@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdint>
+
+// Piece values plus square bonuses for the middlegame and the endgame, in
+// hundredths of the evaluation unit, a pawn being 1120. Black entries are
+// mirrored and negative, so the sums over the board are from white's side.
+extern int16_t piece_square_mg[12][64];
+extern int16_t piece_square_eg[12][64];
+
+// Game phase contributed by each piece: 24 with all minor and major pieces
+// on the board, 0 with pawns and kings only.
+extern uint8_t phase_weights[12];
+
+const int MAX_PHASE = 24;
@@ -0,0 +1,662 @@
+#include "Search.h"
+#include "MovePicker.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+
+bool SearchInfo::checkStop()
+{
+	uint64_t nodes = this->nodes.load(std::memory_order_relaxed) + 1;
+	this->nodes.store(nodes, std::memory_order_relaxed);
+
+	this->stats.seldepth = std::max(this->stats.seldepth, this->ply);
+
+	if (this->timed && (nodes & 1023) == 0 && !this->pondering.load(std::memory_order_relaxed) && std::chrono::steady_clock::now() >= this->deadline)
+		this->stopped = true;
+
+	if (this->depth > 0 && (this->stop_requested.load(std::memory_order_relaxed) || (this->node_limit > 0 && nodes >= this->node_limit)))
+		this->stopped = true;
+
+	return this->stopped;
+}
+
+void SearchInfo::storeCutoff(move16_t move, Figure figure, int depth)
+{
+	if (is_capture(move) || is_promotion(move) || this->ply >= MAX_PLY)
+		return;
+
+	if (this->killers[this->ply][0] != move)
+	{
+		this->killers[this->ply][1] = this->killers[this->ply][0];
+		this->killers[this->ply][0] = move;
+	}
+
+	this->history[figure][move_to(move)] += depth * depth;
+}
+
+NnueHalfAccumulator* SearchInfo::accumulatorSlot()
+{
+	return this->ply < MAX_PLY ? &this->accumulators[this->ply] : nullptr;
+}
+
+uint64_t SearchInfo::totalNodes()
+{
+	uint64_t nodes = this->nodes.load(std::memory_order_relaxed) + this->helper_nodes;
+
+	for (SearchInfo* helper : this->helpers)
+		nodes += helper->nodes.load(std::memory_order_relaxed);
+
+	return nodes;
+}
+
+void SearchStats::add(const SearchStats& other)
+{
+	this->qnodes += other.qnodes;
+
+	this->tt_probes += other.tt_probes;
+	this->tt_hits += other.tt_hits;
+	this->tt_cutoffs += other.tt_cutoffs;
+
+	this->fail_highs += other.fail_highs;
+	this->first_fail_highs += other.first_fail_highs;
+
+	this->seldepth = std::max(this->seldepth, other.seldepth);
+	this->threads += other.threads;
+
+	this->movegen_ns += other.movegen_ns;
+	this->eval_ns += other.eval_ns;
+}
+
+std::string to_json(const SearchStats& stats, int depth, uint64_t nodes, int64_t time)
+{
+	auto ratio = [](double a, double b)
+	{
+		char str[32];
+		std::snprintf(str, sizeof(str), "%.3f", b > 0 ? a / b : 0.0);
+		return std::string(str);
+	};
+
+	std::string str = "{\"depth\":" + std::to_string(depth);
+	str += ",\"seldepth\":" + std::to_string(stats.seldepth);
+	str += ",\"nodes\":" + std::to_string(nodes);
+	str += ",\"counter_threads\":" + std::to_string(stats.threads);
+	str += ",\"qnodes\":" + std::to_string(stats.qnodes);
+	str += ",\"time_ms\":" + std::to_string(time);
+	str += ",\"nps\":" + std::to_string(time > 0 ? nodes * 1000 / time : nodes);
+	str += ",\"tt_probes\":" + std::to_string(stats.tt_probes);
+	str += ",\"tt_hits\":" + std::to_string(stats.tt_hits);
+	str += ",\"tt_cutoffs\":" + std::to_string(stats.tt_cutoffs);
+	str += ",\"tt_hit_rate\":" + ratio((double)stats.tt_hits, (double)stats.tt_probes);
+	str += ",\"fail_highs\":" + std::to_string(stats.fail_highs);
+	str += ",\"first_move_cutoff_rate\":" + ratio((double)stats.first_fail_highs, (double)stats.fail_highs);
+
+	str += ",\"iteration_nodes\":[";
+	for (size_t i = 0; i < stats.iteration_nodes.size(); i++)
+		str += (i > 0 ? "," : "") + std::to_string(stats.iteration_nodes[i]);
+	str += "]";
+
+	// Nodes of the last iteration over those of the one before.
+	size_t count = stats.iteration_nodes.size();
+	str += ",\"branching_factor\":" + (count >= 2 ? ratio((double)stats.iteration_nodes[count - 1], (double)stats.iteration_nodes[count - 2]) : std::string("0.000"));
+
+	if (stats.timing)
+	{
+		str += ",\"movegen_ms\":" + std::to_string(stats.movegen_ns / 1000000);
+		str += ",\"eval_ms\":" + std::to_string(stats.eval_ns / 1000000);
+		str += ",\"search_ms\":" + std::to_string(std::max<int64_t>(time - (stats.movegen_ns + stats.eval_ns) / 1000000, 0));
+	}
+
+	return str + "}";
+}
+
+//------------------------------------------------------------------------------------
+
+TranspositionTable Search::tt(16);
+
+EvalMove Search::iterativeDeepening(ChessGameData* cdata, bool turn, SearchLimits limits, SearchInfo* info)
+{
+	info->start = std::chrono::steady_clock::now();
+
+	bool timed = limits.move_time > 0 || limits.time_left > 0;
+
+	// At least a millisecond, so that a clock close to zero still limits
+	// the search instead of rounding down to no limit at all.
+	int budget = limits.move_time;
+	if (budget == 0 && limits.time_left > 0)
+		budget = std::max(std::min(limits.time_left / 30 + limits.increment * 3 / 4, limits.time_left / 2), 1);
+
+	info->deadline = info->start + std::chrono::milliseconds(budget);
+	info->node_limit = limits.nodes;
+
+	if (!info->tt)
+		info->tt = &Search::tt;
+
+	info->tt->newSearch();
+
+	std::vector<std::thread> threads;
+
+	for (int i = 1; i < limits.threads; i++)
+	{
+		info->helpers.push_back(new SearchInfo());
+		info->helpers.back()->tt = info->tt;
+		info->helpers.back()->stats.timing = info->stats.timing;
+		threads.push_back(std::thread(Search::helper, *cdata, turn, limits, info->helpers.back(), i));
+	}
+
+	EvalMove best;
+	best.score = 0.0f;
+
+	uint64_t searched = 0;
+
+	for (int depth = 1; depth <= limits.depth; depth++)
+	{
+		info->timed = timed && depth > 1;
+
+		EvalMove result = Search::aspiration(cdata, info, depth, turn, best.score);
+
+		if (info->stopped)
+			break;
+
+		best = result;
+		info->depth = depth;
+
+		uint64_t nodes = info->totalNodes();
+		info->stats.iteration_nodes.push_back(nodes - searched);
+		searched = nodes;
+
+		if (info->report)
+			info->report(best);
+
+		auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - info->start).count();
+
+		if ((timed && elapsed * 2 > budget && !info->pondering) || std::abs(best.score) >= 300.0f)
+			break;
+	}
+
+	for (SearchInfo* helper : info->helpers)
+		helper->stop_requested = true;
+
+	for (size_t i = 0; i < threads.size(); i++)
+	{
+		threads[i].join();
+
+		info->helper_nodes += info->helpers[i]->nodes;
+		info->stats.add(info->helpers[i]->stats);
+		delete info->helpers[i];
+	}
+
+	info->helpers.clear();
+
+	return best;
+}
+
+// Lazy SMP: helpers search private copies of the position and share results
+// only through the transposition table. Each skips a different pattern of
+// depths so that the threads do not all work on the same iteration.
+void Search::helper(ChessGameData data, bool turn, SearchLimits limits, SearchInfo* info, int index)
+{
+	const int skip_size[] = { 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4 };
+	const int skip_phase[] = { 0, 1, 0, 1, 2, 3, 0, 1, 2, 3, 4, 5, 0, 1, 2, 3, 4, 5, 6, 7 };
+
+	int i = (index - 1) % 20;
+	float score = 0.0f;
+
+	for (int depth = 1; depth <= limits.depth; depth++)
+	{
+		if (((depth + skip_phase[i]) / skip_size[i]) % 2 != 0)
+			continue;
+
+		float result = Search::aspiration(&data, info, depth, turn, score).score;
+
+		if (info->stopped)
+			break;
+
+		score = result;
+		info->depth = depth;
+	}
+}
+
+// Searches a window around the score of the previous iteration and widens
+// the failing side until the score falls inside it. Shallow iterations and
+// mate scores use the full window.
+EvalMove Search::aspiration(ChessGameData* cdata, SearchInfo* info, int depth, bool turn, float previous)
+{
+	if (depth < 4 || std::abs(previous) >= 300.0f)
+		return Search::minimax(cdata, info, depth, turn, -5000.0f, 5000.0f);
+
+	float delta = ASPIRATION_WINDOW;
+	float alpha = previous - delta;
+	float beta = previous + delta;
+
+	while (true)
+	{
+		EvalMove result = Search::minimax(cdata, info, depth, turn, alpha, beta);
+
+		if (info->stopped)
+			return result;
+
+		delta *= 2.0f;
+
+		if (result.score <= alpha)
+			alpha = delta > 100.0f ? -5000.0f : std::max(result.score - delta, -5000.0f);
+		else if (result.score >= beta)
+			beta = delta > 100.0f ? 5000.0f : std::min(result.score + delta, 5000.0f);
+		else
+			return result;
+	}
+}
+
+EvalMove Search::minimax(ChessGameData* cdata, SearchInfo* info, int depth, bool turn, float alpha, float beta)
+{
+	EvalMove best;
+
+	if (depth == 0)
+	{
+		best.score = Search::quiescence(cdata, info, turn, alpha, beta);
+		return best;
+	}
+
+	if (info->checkStop())
+		return best;
+
+	Ending ending = IMPOSSIBILITY;
+
+	uint64_t key = cdata->board.getKey();
+
+	TTEntry entry;
+	bool hit = info->tt->probe(key, entry);
+
+	info->stats.tt_probes++;
+	info->stats.tt_hits += hit;
+
+	// The root always searches its moves, so that there is one to play.
+	if (hit && entry.depth >= depth && info->ply > 0)
+	{
+		if (entry.bound == BOUND_EXACT ||
+			(entry.bound == BOUND_LOWER && entry.score >= beta) ||
+			(entry.bound == BOUND_UPPER && entry.score <= alpha))
+		{
+			if (ChessRules::isValid(cdata, entry.move))
+			{
+				info->stats.tt_cutoffs++;
+
+				best.score = entry.score;
+				best.move = entry.move;
+				return best;
+			}
+		}
+	}
+
+	if (info->ply > 0 && ChessRules::checkImpossibility(cdata))
+	{
+		best.score = ChessRules::calcScore(cdata, false, IMPOSSIBILITY);
+		return best;
+	}
+
+	bool in_check = cdata->checkers != 0;
+	bool pv_node = beta - alpha > NULL_WINDOW * 2.0f;
+
+	// Null move pruning: if passing the turn still fails high, so would the
+	// best move. Not tried twice in a row, nor with only pawns left, where
+	// zugzwang is common.
+	bitboard_t pieces = cdata->board.getOccupancy(turn) & ~cdata->board.getBitboard(turn ? wP : bP) & ~cdata->board.getBitboard(turn ? wK : bK);
+
+	if (!pv_node && info->ply > 0 && !in_check && depth >= 3 && pieces && cdata->prev_move.from != cdata->prev_move.to)
+	{
+		float eval = Search::evaluate(cdata, info);
+
+		if (turn ? eval > beta : eval < alpha)
+		{
+			int null_depth = std::max(depth - (depth >= 6 ? 4 : 3), 0);
+
+			UndoData undo;
+			ChessRules::makeNullMove(cdata, undo);
+
+			info->ply++;
+			float score = turn ?
+				minimax(cdata, info, null_depth, false, beta, beta + NULL_WINDOW).score :
+				minimax(cdata, info, null_depth, true, alpha - NULL_WINDOW, alpha).score;
+			info->ply--;
+
+			ChessRules::unmakeNullMove(cdata, undo);
+
+			if (info->stopped)
+				return best;
+
+			if (turn ? score > beta && score < 300.0f : score < alpha && score > -300.0f)
+			{
+				best.score = score;
+				return best;
+			}
+		}
+	}
+
+	MovePicker picker(cdata, info, turn, false, hit ? entry.move : NO_MOVE);
+
+	move16_t move;
+	int count = 0;
+
+	//best.move = moves[0];
+
+	float alpha_start = alpha;
+	float beta_start = beta;
+
+	if (turn)
+	{
+		best.score = -5000.0f;
+
+		while (picker.next(move))
+		{
+			EvalMove emove;
+			emove.move = move;
+
+			Figure figure;
+			cdata->board.getFigure(to_pos(move_from(move)), figure);
+
+			UndoData undo;
+			undo.accumulator = info->accumulatorSlot();
+			ChessRules::makeMove(cdata, move, undo);
+
+			// Moves after the first only have to be proven no better than
+			// alpha, late quiet ones at a reduced depth. They are searched
+			// again at full depth and with the full window otherwise.
+			int reduction = Search::reduction(info, move, depth, count, in_check, cdata->checkers != 0);
+
+			info->ply++;
+			if (count == 0)
+				emove.score = minimax(cdata, info, depth - 1, false, alpha, beta).score;
+			else
+			{
+				emove.score = minimax(cdata, info, depth - 1 - reduction, false, alpha, alpha + NULL_WINDOW).score;
+
+				if (reduction > 0 && emove.score > alpha && !info->stopped)
+					emove.score = minimax(cdata, info, depth - 1, false, alpha, alpha + NULL_WINDOW).score;
+
+				if (emove.score > alpha && emove.score < beta && !info->stopped)
+					emove.score = minimax(cdata, info, depth - 1, false, alpha, beta).score;
+			}
+			info->ply--;
+
+			ChessRules::unmakeMove(cdata, move, undo);
+
+			count++;
+
+			if (info->stopped)
+				return best;
+
+			if (emove.score > best.score)
+				best = emove;
+
+			/*if (emove.score < alpha)
+			{
+				return best;
+			}
+			if (emove.score < beta)
+			{
+				beta = emove.score;
+			}*/
+
+			//------------------------------
+
+			if (emove.score > beta)
+			{
+				info->storeCutoff(move, figure, depth);
+
+				info->stats.fail_highs++;
+				info->stats.first_fail_highs += count == 1;
+				break;
+			}
+			if (emove.score > alpha)
+			{
+				alpha = emove.score;
+			}
+
+			/*alpha = std::max(alpha, best.score);
+
+			if (beta <= alpha)
+				return best;*/
+		}
+	}
+	else
+	{
+		best.score = 5000.0f;
+
+		while (picker.next(move))
+		{
+			EvalMove emove;
+			emove.move = move;
+
+			Figure figure;
+			cdata->board.getFigure(to_pos(move_from(move)), figure);
+
+			UndoData undo;
+			undo.accumulator = info->accumulatorSlot();
+			ChessRules::makeMove(cdata, move, undo);
+
+			int reduction = Search::reduction(info, move, depth, count, in_check, cdata->checkers != 0);
+
+			info->ply++;
+			if (count == 0)
+				emove.score = minimax(cdata, info, depth - 1, true, alpha, beta).score;
+			else
+			{
+				emove.score = minimax(cdata, info, depth - 1 - reduction, true, beta - NULL_WINDOW, beta).score;
+
+				if (reduction > 0 && emove.score < beta && !info->stopped)
+					emove.score = minimax(cdata, info, depth - 1, true, beta - NULL_WINDOW, beta).score;
+
+				if (emove.score < beta && emove.score > alpha && !info->stopped)
+					emove.score = minimax(cdata, info, depth - 1, true, alpha, beta).score;
+			}
+			info->ply--;
+
+			ChessRules::unmakeMove(cdata, move, undo);
+
+			count++;
+
+			if (info->stopped)
+				return best;
+
+			if (emove.score < best.score)
+				best = emove;
+
+			/*if (emove.score > beta)
+			{
+				return best;
+			}
+			if (emove.score > alpha)
+			{
+				alpha = emove.score;
+			}*/
+
+			//------------------------------
+
+			if (emove.score < alpha)
+			{
+				info->storeCutoff(move, figure, depth);
+
+				info->stats.fail_highs++;
+				info->stats.first_fail_highs += count == 1;
+				break;
+			}
+			if (emove.score < beta)
+			{
+				beta = emove.score;
+			}
+
+			/*beta = std::min(beta, best.score);
+
+			if (beta <= alpha)
+				return best;*/
+		}
+	}
+
+	if (count == 0)
+	{
+		if (ChessRules::isAttacked(cdata, cdata->board.findKing(turn), !turn))
+			ending = turn ? BLACK_WIN : WHITE_WIN;
+		else
+			ending = STALEMATE;
+
+		best.score = ChessRules::calcScore(cdata, false, ending);
+		return best;
+	}
+
+	Bound bound = BOUND_EXACT;
+	if (best.score <= alpha_start)
+		bound = BOUND_UPPER;
+	else if (best.score >= beta_start)
+		bound = BOUND_LOWER;
+
+	info->tt->store(key, best.score, bound, depth, best.move);
+
+	return best;
+}
+
+// Late move reductions: quiet moves ordered after the hash move, the
+// captures and the killers are searched a ply shallower, two from depth 6
+// once the first few moves failed to raise alpha.
+int Search::reduction(SearchInfo* info, move16_t move, int depth, int count, bool in_check, bool gives_check)
+{
+	if (depth < 3 || count < 3 || in_check || gives_check || is_capture(move) || is_promotion(move))
+		return 0;
+
+	if (info->ply < MAX_PLY && (move == info->killers[info->ply][0] || move == info->killers[info->ply][1]))
+		return 0;
+
+	return depth >= 6 && count >= 6 ? 2 : 1;
+}
+
+float Search::quiescence(ChessGameData* cdata, SearchInfo* info, bool turn, float alpha, float beta)
+{
+	float best = 0.0f;
+
+	if (info->checkStop())
+		return best;
+
+	info->stats.qnodes++;
+
+	bool in_check = cdata->checkers != 0;
+
+	float stand_pat = Search::evaluate(cdata, info);
+
+	if (info->ply >= MAX_PLY - 1)
+		return stand_pat;
+
+	if (in_check)
+		best = turn ? -5000.0f : 5000.0f;
+	else
+	{
+		best = stand_pat;
+
+		if ((turn && stand_pat > beta) || (!turn && stand_pat < alpha))
+			return stand_pat;
+
+		if (turn)
+			alpha = std::max(alpha, stand_pat);
+		else
+			beta = std::min(beta, stand_pat);
+	}
+
+	MovePicker picker(cdata, info, turn, !in_check, NO_MOVE);
+
+	move16_t move;
+	int count = 0;
+
+	while (picker.next(move))
+	{
+		count++;
+
+		if (!in_check)
+		{
+			Figure victim;
+			if (!cdata->board.getFigure(to_pos(move_to(move)), victim))
+				victim = wP;
+
+			float gain = ((is_capture(move) ? fscore(victim) : 0) + (is_promotion(move) ? fscore((Figure)(wQ + (move_flags(move) & 3))) - 1 : 0)) * 11.2f + 22.4f;
+
+			if ((turn && stand_pat + gain < alpha) || (!turn && stand_pat - gain > beta))
+				continue;
+		}
+
+		UndoData undo;
+		undo.accumulator = info->accumulatorSlot();
+		ChessRules::makeMove(cdata, move, undo);
+
+		info->ply++;
+		float score = Search::quiescence(cdata, info, !turn, alpha, beta);
+		info->ply--;
+
+		ChessRules::unmakeMove(cdata, move, undo);
+
+		if (info->stopped)
+			return best;
+
+		if (turn)
+		{
+			best = std::max(best, score);
+
+			if (score > beta)
+				break;
+			alpha = std::max(alpha, score);
+		}
+		else
+		{
+			best = std::min(best, score);
+
+			if (score < alpha)
+				break;
+			beta = std::min(beta, score);
+		}
+	}
+
+	if (in_check && count == 0)
+		best = ChessRules::calcScore(cdata, false, turn ? BLACK_WIN : WHITE_WIN);
+
+	return best;
+}
+
+float Search::evaluate(ChessGameData* cdata, SearchInfo* info)
+{
+	if (!info->stats.timing)
+		return ChessRules::calcScore(cdata, true, IMPOSSIBILITY);
+
+	auto start = std::chrono::steady_clock::now();
+	float score = ChessRules::calcScore(cdata, true, IMPOSSIBILITY);
+	info->stats.eval_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+	return score;
+}
+
+std::vector<move16_t> Search::extractPv(ChessGameData* cdata, bool turn, move16_t move, int length, TranspositionTable* tt)
+{
+	std::vector<move16_t> pv;
+	std::vector<UndoData> undos;
+
+	if (move == NO_MOVE)
+		return pv;
+
+	pv.push_back(move);
+
+	while (true)
+	{
+		undos.push_back(UndoData());
+		ChessRules::makeMove(cdata, pv.back(), undos.back());
+		turn = !turn;
+
+		if ((int)pv.size() >= length)
+			break;
+
+		TTEntry entry;
+		if (!tt->probe(cdata->board.getKey(), entry) || entry.bound != BOUND_EXACT || !ChessRules::isValid(cdata, entry.move))
+			break;
+
+		pv.push_back(entry.move);
+	}
+
+	for (int i = (int)pv.size() - 1; i >= 0; i--)
+		ChessRules::unmakeMove(cdata, pv[i], undos[i]);
+
+	return pv;
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "ChessRules.h"
+#include "TranspositionTable.h"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string>
+
+const int MAX_PLY = 128;
+
+// Scores closer than this are treated as equal by the null window searches.
+const float NULL_WINDOW = 0.01f;
+
+// First aspiration half-width, a fifth of a pawn, doubled on every failure.
+const float ASPIRATION_WINDOW = 2.24f;
+
+struct SearchLimits
+{
+	int depth = 64;
+
+	int move_time = 0;
+	int time_left = 0;
+	int increment = 0;
+
+	uint64_t nodes = 0;
+
+	int threads = 1;
+};
+
+// Counters of one search for tuning. The owner may set timing to also
+// measure move generation and evaluation, which costs a clock read each.
+struct SearchStats
+{
+	uint64_t qnodes = 0;
+
+	uint64_t tt_probes = 0;
+	uint64_t tt_hits = 0;
+	uint64_t tt_cutoffs = 0;
+
+	// Nodes that failed high, and those of them that did on the first move.
+	uint64_t fail_highs = 0;
+	uint64_t first_fail_highs = 0;
+
+	int seldepth = 0;
+
+	bool timing = false;
+	int64_t movegen_ns = 0;
+	int64_t eval_ns = 0;
+
+	// Nodes searched by each completed iteration, for the branching factor.
+	std::vector<uint64_t> iteration_nodes;
+
+	// Threads whose counters are included. Those of helpers are only added
+	// when the search ends, while iteration_nodes counts all of them.
+	int threads = 1;
+
+	void add(const SearchStats& other);
+};
+
+// One line of JSON with the counters and the rates derived from them.
+// nodes and nps are of all threads, the counters of stats.threads.
+std::string to_json(const SearchStats& stats, int depth, uint64_t nodes, int64_t time);
+
+struct SearchInfo
+{
+	std::chrono::steady_clock::time_point start;
+	std::chrono::steady_clock::time_point deadline;
+
+	bool timed = false;
+	bool stopped = false;
+
+	// May be set from another thread. Like the node limit, it is only honored
+	// once the first iteration is complete, so there is always a move to play.
+	std::atomic<bool> stop_requested{ false };
+
+	// Set by the owner before the search starts to search on the opponent's
+	// time. The time limits are ignored until it is cleared by a ponder hit,
+	// then they apply as if the search had started on our own clock.
+	std::atomic<bool> pondering{ false };
+
+	// Only written by the thread that owns this SearchInfo, atomic so that
+	// the main thread can sum the counts of the helpers while they run.
+	std::atomic<uint64_t> nodes{ 0 };
+	uint64_t node_limit = 0;
+	int depth = 0;
+
+	// Lazy SMP helpers of the main search, and the nodes of finished ones.
+	std::vector<SearchInfo*> helpers;
+	uint64_t helper_nodes = 0;
+
+	// Called after every completed iteration of iterativeDeepening.
+	std::function<void(EvalMove& best)> report;
+
+	// Table probed and filled by the search, Search::tt unless the owner
+	// gives one of its own, as engines playing each other must.
+	TranspositionTable* tt = nullptr;
+
+	// Those of helpers are added when they finish, at the end of the search.
+	SearchStats stats;
+
+	int ply = 0;
+	move16_t killers[MAX_PLY][2] = {};
+	int history[12][64] = {};
+
+	// Accumulator halves saved by the king moves made at each ply.
+	NnueHalfAccumulator accumulators[MAX_PLY];
+
+	bool checkStop();
+	void storeCutoff(move16_t move, Figure figure, int depth);
+
+	// Where a move made at this ply saves its accumulator half, if anywhere.
+	NnueHalfAccumulator* accumulatorSlot();
+
+	uint64_t totalNodes();
+};
+
+class Search
+{
+public:
+	static TranspositionTable tt;
+
+	static EvalMove iterativeDeepening(ChessGameData* data, bool turn, SearchLimits limits, SearchInfo* info);
+	static void helper(ChessGameData data, bool turn, SearchLimits limits, SearchInfo* info, int index);
+	static EvalMove aspiration(ChessGameData* data, SearchInfo* info, int depth, bool turn, float previous);
+	static EvalMove minimax(ChessGameData* data, SearchInfo* info, int depth, bool turn, float alpha, float beta);
+	static int reduction(SearchInfo* info, move16_t move, int depth, int count, bool in_check, bool gives_check);
+	static float quiescence(ChessGameData* data, SearchInfo* info, bool turn, float alpha, float beta);
+	static float evaluate(ChessGameData* data, SearchInfo* info);
+
+	// Follows the exact entries of tt from move, the table the search used.
+	static std::vector<move16_t> extractPv(ChessGameData* data, bool turn, move16_t move, int length, TranspositionTable* tt);
+};
@@ -0,0 +1,154 @@
+#include "TranspositionTable.h"
+#include <cstring>
+#include <new>
+
+uint64_t pack(float score, Bound bound, uint8_t depth, uint8_t generation, uint16_t move)
+{
+	uint32_t bits;
+	std::memcpy(&bits, &score, sizeof(bits));
+
+	return (uint64_t)bits |
+		((uint64_t)depth << 32) |
+		((uint64_t)bound << 40) |
+		((uint64_t)(generation & 63) << 42) |
+		((uint64_t)move << 48);
+}
+
+uint8_t depth_of(uint64_t data)
+{
+	return (uint8_t)(data >> 32);
+}
+
+Bound bound_of(uint64_t data)
+{
+	return (Bound)((data >> 40) & 3);
+}
+
+uint8_t generation_of(uint64_t data)
+{
+	return (uint8_t)((data >> 42) & 63);
+}
+
+//------------------------------------------------------------------------------------
+
+TranspositionTable::TranspositionTable(size_t size_mb)
+{
+	this->memory = nullptr;
+	this->buckets = nullptr;
+	this->count = 0;
+	this->generation = 0;
+
+	this->resize(size_mb);
+}
+
+TranspositionTable::~TranspositionTable()
+{
+	delete[] this->memory;
+}
+
+void TranspositionTable::resize(size_t size_mb)
+{
+	delete[] this->memory;
+
+	this->count = 1;
+	while (this->count * 2 * sizeof(Bucket) <= size_mb * 1024 * 1024)
+		this->count *= 2;
+
+	this->memory = new uint8_t[this->count * sizeof(Bucket) + 63];
+	this->buckets = (Bucket*)(((uintptr_t)this->memory + 63) & ~(uintptr_t)63);
+
+	for (size_t i = 0; i < this->count; i++)
+		new (&this->buckets[i]) Bucket();
+
+	this->clear();
+}
+
+void TranspositionTable::clear()
+{
+	for (size_t i = 0; i < this->count; i++)
+	{
+		for (auto& slot : this->buckets[i].slots)
+		{
+			slot.check.store(0, std::memory_order_relaxed);
+			slot.data.store(0, std::memory_order_relaxed);
+		}
+	}
+
+	this->generation = 0;
+}
+
+void TranspositionTable::newSearch()
+{
+	this->generation = (this->generation + 1) & 63;
+}
+
+bool TranspositionTable::probe(uint64_t key, TTEntry& entry)
+{
+	Bucket& bucket = this->buckets[key & (this->count - 1)];
+
+	for (auto& slot : bucket.slots)
+	{
+		uint64_t data = slot.data.load(std::memory_order_relaxed);
+		uint64_t check = slot.check.load(std::memory_order_relaxed);
+
+		if ((check ^ data) != key || bound_of(data) == BOUND_NONE)
+			continue;
+
+		uint32_t bits = (uint32_t)data;
+		std::memcpy(&entry.score, &bits, sizeof(bits));
+
+		entry.bound = bound_of(data);
+		entry.depth = depth_of(data);
+		entry.move = (uint16_t)(data >> 48);
+		return true;
+	}
+
+	return false;
+}
+
+void TranspositionTable::store(uint64_t key, float score, Bound bound, int depth, uint16_t move)
+{
+	Bucket& bucket = this->buckets[key & (this->count - 1)];
+
+	Slot* replace = nullptr;
+
+	for (auto& slot : bucket.slots)
+	{
+		if ((slot.check.load(std::memory_order_relaxed) ^ slot.data.load(std::memory_order_relaxed)) == key)
+		{
+			replace = &slot;
+			break;
+		}
+	}
+
+	if (replace == nullptr)
+	{
+		// Slots 0-2 keep the deepest results of the current search, slot 3 always takes the newest one.
+		Slot* shallowest = &bucket.slots[0];
+		int shallowest_depth = 256;
+
+		for (uint8_t i = 0; i < 3; i++)
+		{
+			uint64_t data = bucket.slots[i].data.load(std::memory_order_relaxed);
+			int value = generation_of(data) == this->generation ? depth_of(data) : -1;
+
+			if (value < shallowest_depth)
+			{
+				shallowest = &bucket.slots[i];
+				shallowest_depth = value;
+			}
+		}
+
+		replace = depth >= shallowest_depth ? shallowest : &bucket.slots[3];
+	}
+
+	if (depth < 0)
+		depth = 0;
+	else if (depth > 255)
+		depth = 255;
+
+	uint64_t data = pack(score, bound, (uint8_t)depth, this->generation, move);
+
+	replace->check.store(key ^ data, std::memory_order_relaxed);
+	replace->data.store(data, std::memory_order_relaxed);
+}
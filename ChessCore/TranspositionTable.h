@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+enum Bound : uint8_t
+{
+	BOUND_NONE,
+	BOUND_UPPER,
+	BOUND_LOWER,
+	BOUND_EXACT
+};
+
+struct TTEntry
+{
+	float score;
+	Bound bound;
+	uint8_t depth;
+
+	uint16_t move;
+};
+
+// Entries are stored as (key ^ data, data) pairs with relaxed atomics, so
+// any number of search threads can share the table without locks: a torn
+// write fails the key check on probe and reads as a miss.
+class TranspositionTable
+{
+public:
+	TranspositionTable(size_t size_mb);
+	~TranspositionTable();
+
+	void resize(size_t size_mb);
+	void clear();
+	void newSearch();
+
+	bool probe(uint64_t key, TTEntry& entry);
+	void store(uint64_t key, float score, Bound bound, int depth, uint16_t move);
+
+private:
+	struct Slot
+	{
+		std::atomic<uint64_t> check;
+		std::atomic<uint64_t> data;
+	};
+
+	struct Bucket
+	{
+		Slot slots[4];
+	};
+
+	uint8_t* memory;
+	Bucket* buckets;
+	size_t count;
+
+	uint8_t generation;
+};
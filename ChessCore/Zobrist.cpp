@@ -0,0 +1,39 @@
+#include "Zobrist.h"
+
+uint64_t zobrist_pieces[12][64];
+uint64_t zobrist_castling[4];
+uint64_t zobrist_en_passant[8];
+uint64_t zobrist_side;
+
+uint64_t random_key(uint64_t& seed)
+{
+	seed ^= seed >> 12;
+	seed ^= seed << 25;
+	seed ^= seed >> 27;
+	return seed * 2685821657736338717ULL;
+}
+
+void init_zobrist()
+{
+	uint64_t seed = 1070372;
+
+	for (uint8_t figure = 0; figure < 12; figure++)
+		for (uint8_t square = 0; square < 64; square++)
+			zobrist_pieces[figure][square] = random_key(seed);
+
+	for (uint8_t i = 0; i < 4; i++)
+		zobrist_castling[i] = random_key(seed);
+
+	for (uint8_t file = 0; file < 8; file++)
+		zobrist_en_passant[file] = random_key(seed);
+
+	zobrist_side = random_key(seed);
+}
+
+struct ZobristInit
+{
+	ZobristInit()
+	{
+		init_zobrist();
+	}
+} zobrist_init;
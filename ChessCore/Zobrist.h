@@ -0,0 +1,8 @@
+#pragma once
+
+#include <cstdint>
+
+extern uint64_t zobrist_pieces[12][64];
+extern uint64_t zobrist_castling[4];
+extern uint64_t zobrist_en_passant[8];
+extern uint64_t zobrist_side;